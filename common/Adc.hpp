@@ -1,14 +1,40 @@
 #ifndef MICROTECH_ADC_HPP
 #define MICROTECH_ADC_HPP
 
-#include "MovingAverage.hpp"
+#include "AdcFilters.hpp"
+#include "Timer.hpp"
 #include "helpers.hpp"
 #include <msp430g2553.h>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <array>
 
 namespace Microtech {
 
+/**
+ * Sources that start the conversions of the ADC. Only the output units of the timer 0 are connected to the ADC.
+ * Every timer trigger takes over the whole timer 0: it runs in up mode with the sample period in TA0CCR0,
+ * so it cannot be used by a Pwm or by tasks at the same time.
+ */
+enum class AdcTrigger : uint16_t {
+  SOFTWARE = SHS_0,     ///< ADC10SC bit. The ADC converts continuously as fast as its clock allows
+  TIMER0_OUT1 = SHS_1,  ///< TA0.1 output unit. Uses TA0CCR0 and TA0CCR1
+  TIMER0_OUT0 = SHS_2,  ///< TA0.0 output unit. Uses TA0CCR0
+  TIMER0_OUT2 = SHS_3,  ///< TA0.2 output unit. Uses TA0CCR0 and TA0CCR2
+};
+
+/**
+ * Positive references of the ADC. The negative reference is always VSS.
+ * The internal reference generator needs up to 30us to settle after it is switched on, so the first
+ * conversions after switching to an internal reference should be discarded.
+ */
+enum class AdcReference : uint16_t {
+  VCC = SREF_0,                             ///< Full scale is VCC. Needs no settling time nor extra current
+  INTERNAL_1V5 = SREF_1 + REFON,            ///< Full scale is 1.5V
+  INTERNAL_2V5 = SREF_1 + REFON + REF2_5V,  ///< Full scale is 2.5V. Needs a supply voltage of at least 2.9V
+};
+
 /**
  * Class to provide access to a ADC port
  */
@@ -22,32 +48,201 @@ public:
    * @return the latest raw value
    */
   uint16_t getRawValue() const noexcept {
-    return rawValue;
+    return rawValue;  // Written by the DTC, so it is read from the memory every time
   }
-  /**
-   * Method to get the latest filtered ADC value
-   * @return the latest filtered value
-   */
-  //uint16_t getFilteredValue() noexcept {
-  //  return smaFilter.filterNewSample(rawValue);
-  //}
+  // Filtered values are provided by the FilteredAdcHandle, which filters every sample once in the ADC interrupt.
 
 protected:
   /**
    * Protected constructor so only the ADC class can create a handle.
    * @param adcValueRef the reference to where the raw value will be written
    */
-  constexpr AdcHandle(uint16_t& adcValueRef) : rawValue(adcValueRef) {}
+  constexpr AdcHandle(volatile uint16_t& adcValueRef) : rawValue(adcValueRef) {}
+
+private:
+  volatile uint16_t& rawValue;        ///< Reference to the raw value.
+};
+
+/**
+ * Class that serves as a base for the handles that process every new conversion of a channel in the ADC
+ * interrupt, in the same way TaskHandlerBase serves for TaskHandler. The Adc keeps a list of the registered
+ * listeners and passes each of them the new value of its channel after every sequence.
+ */
+class AdcListenerBase {
+  friend class Adc;
+
+public:
+  AdcListenerBase(const AdcListenerBase&) = delete;
+  AdcListenerBase& operator=(const AdcListenerBase&) = delete;
+
+  /**
+   * @return The channel the listener is registered to.
+   */
+  uint8_t getChannel() const noexcept {
+    return channel;
+  }
+
+protected:
+  AdcListenerBase() = default;
+  ~AdcListenerBase() = default;
+
+private:
+  /**
+   * Called by the ADC interrupt with every new conversion of the channel.
+   */
+  virtual void newSample(uint16_t sample) = 0;
+
+  AdcListenerBase* next = nullptr;  ///< Next listener of the list of the Adc
+  uint8_t channel = 0;
+  bool isRegistered = false;
+};
+
+/**
+ * Handle whose value is processed by a filter once per conversion, in the ADC interrupt. So reading the value
+ * only costs a memory access and the filter sees every sample exactly once. E.g. for an NTC read with 12 bits:
+ *  @code
+ *    FilteredAdcHandle<Decimator<2>> ntcInput;
+ *    Adc::getInstance().setTimerTrigger<AdcTrigger::TIMER0_OUT0, 1, std::chrono::milliseconds>(ADC_TIMER_CONFIG);
+ *    Adc::getInstance().registerListener<5>(ntcInput);
+ *    ...
+ *    const uint16_t temperatureValue = ntcInput.getValue();  // 0 to 4092
+ *  @endcode
+ *
+ * @tparam Filter Type of the filter. It must have a method "bool processSample(uint16_t& sample)" that
+ *                replaces the sample by the filtered value and returns true if there is a new output
+ *                (a decimating filter does not give an output for every sample). See AdcFilters.hpp.
+ */
+template<typename Filter>
+class FilteredAdcHandle : public AdcListenerBase {
+public:
+  FilteredAdcHandle() = default;
+
+  /**
+   * @return The latest output of the filter.
+   */
+  uint16_t getValue() const noexcept {
+    return value;
+  }
+
+  /**
+   * @return Free running counter of the outputs of the filter. A change means that there is a new value.
+   */
+  uint16_t getNumValues() const noexcept {
+    return numValues;
+  }
 
 private:
-  //SimpleMovingAverage<30> smaFilter;  ///< Moving Averaget filter of 30 samples. This can be templated in the future.
-  uint16_t& rawValue;                 ///< Reference to the raw value.
+  void newSample(uint16_t sample) override {
+    if (filter.processSample(sample)) {
+      value = sample;
+      numValues = numValues + 1;
+    }
+  }
+
+  Filter filter;
+  volatile uint16_t value = 0;
+  volatile uint16_t numValues = 0;
 };
 
+/**
+ * Listener that divides the range of a channel in bands separated by thresholds and calls a callback, in the
+ * ADC interrupt, only when the value moves to another band. So the application does not need to poll the value.
+ * To avoid toggling when the value is noisy, the value must fall below a threshold by more than the hysteresis
+ * to go back to the lower band. The callback should be short, so slow work like writing the LEDs of a
+ * potentiometer with the shift register is handed over to the main loop. E.g.:
+ *  @code
+ *    void potentiometerBandChanged(uint8_t band) {
+ *      potentiometerBand = band;
+ *      deferredQueue.post(&writePotentiometerLeds);  // Writes LED_PATTERNS[potentiometerBand] to the shift register
+ *    }
+ *    AdcThresholdEvent<4> potentiometerEvent({{204, 408, 612, 816}}, 8, &potentiometerBandChanged);
+ *    Adc::getInstance().registerListener<7>(potentiometerEvent);
+ *  @endcode
+ *
+ * @tparam NUM_THRESHOLDS Number of thresholds. There is one band more than thresholds.
+ * @tparam Filter Optional filter applied to the samples before they are evaluated (see FilteredAdcHandle).
+ */
+template<uint8_t NUM_THRESHOLDS, typename Filter = Chain<>>
+class AdcThresholdEvent : public AdcListenerBase {
+  static_assert(NUM_THRESHOLDS > 0 && NUM_THRESHOLDS < 0xFF, "Invalid number of thresholds");
+
+public:
+  typedef void (*BandChangedCallback)(uint8_t band);  ///< Type definition of the callback
+  static constexpr uint8_t NO_BAND = 0xFF;            ///< Band before the first sample is evaluated
+
+  /**
+   * Class constructor.
+   * @param thresholds Thresholds in ascending order. Band n goes from thresholds[n - 1] to thresholds[n] - 1.
+   * @param hysteresis Counts the value must fall below a threshold to go back to the lower band
+   * @param callback Called with the new band when it changes, also for the first sample. Can be nullptr.
+   */
+  AdcThresholdEvent(const std::array<uint16_t, NUM_THRESHOLDS>& thresholds, uint16_t hysteresis,
+                    BandChangedCallback callback)
+    : thresholds(thresholds), hysteresis(hysteresis), callback(callback) {}
+
+  /**
+   * @return The current band. NO_BAND if no sample was evaluated yet.
+   */
+  uint8_t getBand() const noexcept {
+    return band;
+  }
+
+private:
+  void newSample(uint16_t sample) override {
+    if (!filter.processSample(sample)) {
+      return;
+    }
+    uint8_t newBand = (band == NO_BAND) ? 0 : band;
+    while (newBand < NUM_THRESHOLDS && sample >= thresholds[newBand]) {
+      newBand++;
+    }
+    while (newBand > 0 && static_cast<uint32_t>(sample) + hysteresis < thresholds[newBand - 1]) {
+      newBand--;
+    }
+    if (newBand == band) {
+      return;
+    }
+    band = newBand;
+    if (callback != nullptr) {
+      callback(newBand);
+    }
+  }
+
+  Filter filter;
+  const std::array<uint16_t, NUM_THRESHOLDS> thresholds;
+  const uint16_t hysteresis;
+  const BandChangedCallback callback;
+  volatile uint8_t band = NO_BAND;
+};
+
+/**
+ * Class to abstract the ADC10. It converts all requested channels in a repeated sequence and the DTC writes
+ * the results to memory, so every AdcHandle gets refreshed values without any CPU involvement.
+ *
+ * The sequence always starts at the channel in INCH and goes down to A0, and the DTC writes the results
+ * in this (descending) order. So the values are stored in descending channel order as well: the value of the
+ * channel c is always at adcValues[MAX_CHANNEL - c], and the DTC block starts at the entry of the highest
+ * requested channel. Like that, the entry of a handle does not depend on the other channels requested.
+ *
+ * Besides the pins A0 to A7, the internal channels 10 (temperature sensor) and 11 ((VCC - VSS) / 2) can be
+ * requested. Since the sequence always goes down to A0, requesting an internal channel also converts the
+ * channels 8 and 9, whose values are simply not used. AdcScale converts the values to millivolts and degrees.
+ */
 class Adc {
   Adc() = default;
 
 public:
+  static constexpr uint8_t MAX_CHANNEL = 11;          ///< Highest channel that can be requested
+  static constexpr uint8_t TEMPERATURE_CHANNEL = 10;  ///< Internal temperature sensor
+  static constexpr uint8_t HALF_VCC_CHANNEL = 11;     ///< Internal (VCC - VSS) / 2 divider
+
+  /**
+   * Type definition of the callbacks of the streaming mode.
+   * @param samples First sample of the block that was completely written by the DTC
+   * @param numSamples Number of samples of the block
+   */
+  typedef void (*BlockCallback)(const uint16_t* samples, uint8_t numSamples);
+
   // Deleted copy and move constructors
   Adc(Adc&) = delete;
   Adc(Adc&&) = delete;
@@ -73,11 +268,384 @@ public:
     // Make sure the ADC is not running.
     ADC10CTL0 &= ~ENC;
     while (ADC10CTL1 & ADC10BUSY){}
-    // ADC10 on
-    // sample and hold time = 16 ADC Clock cycles = 8*0.2us = 1.6 us
-    // Multiple sample and conversion on.
-    ADC10CTL0 = ADC10ON + ADC10SHT_1 + MSC;
+    configureMode(false);
+    isInitialized = true;
+  }
 
+  /**
+   * Method that starts the ADC conversion
+   * Previous to this call, one has to already have requested the ADC handles, as well as
+   * initialized the ADC.
+   */
+  void startConversion() {
+    setRegisterBits(ADC10CTL0, static_cast<uint16_t>(ADC10SC + ENC));
+  }
+
+  /**
+   * Method to start every conversion with a timer 0 output unit instead of converting continuously.
+   * The sample rate comes from the hardware, so it is free of jitter and needs no CPU per sample.
+   * The timer 0 is initialized with the config and runs in up mode with the sample period, so it cannot be
+   * used by a Pwm or for tasks at the same time. If the timer 0 is already running for them, the trigger is
+   * not changed. The period must be a whole number of timer counts, with TIMER0_OUT0 even an even number,
+   * otherwise the compilation fails instead of rounding the sample rate. E.g. for the oscilloscope at 4kHz:
+   *  @code
+   *    constexpr TimerConfigBase<1, 1> ADC_TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+   *    Adc::getInstance().init();
+   *    Adc::getInstance().setTimerTrigger<AdcTrigger::TIMER0_OUT0, 250>(ADC_TIMER_CONFIG);
+   *    Adc::getInstance().startStreaming<0>(oscilloscopeSamples, &firstHalfReady, &secondHalfReady);
+   *  @endcode
+   *
+   * Each trigger converts one sample. So in the sequence of the AdcHandles each channel is refreshed
+   * every (highest channel + 1) periods, and in the streaming mode every period gives one sample.
+   *
+   * @tparam TRIGGER Timer output unit that triggers the conversions
+   * @tparam periodValue Period between two conversions
+   * @tparam Duration Time scale of the period (milliseconds, microseconds...)
+   * @param config Configuration of the timer 0 in up mode
+   * @return true if the trigger was set. False if the timer 0 is already running for something else.
+   */
+  template<AdcTrigger TRIGGER, uint64_t periodValue, typename Duration = std::chrono::microseconds,
+           int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE, typename TickDuration,
+           int64_t SOURCE_CLK_PERIOD_DEN>
+  bool setTimerTrigger(
+    const TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_VALUE, TickDuration, SOURCE_CLK_PERIOD_DEN>& config) {
+    static_assert(TRIGGER != AdcTrigger::SOFTWARE, "Use setSoftwareTrigger() for the software trigger");
+    constexpr uint64_t PERIOD_US =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Duration(periodValue)).count());
+    // OUT0 toggles at every CCR0 match, so it only rises every second match.
+    constexpr uint64_t COMPARES_PER_PERIOD = (TRIGGER == AdcTrigger::TIMER0_OUT0) ? 2 : 1;
+    constexpr uint64_t COMPARE_PERIOD_US = PERIOD_US / COMPARES_PER_PERIOD;
+    // A timer count lasts CLK_DIV * SOURCE_CLK_PERIOD_US / SOURCE_CLK_PERIOD_DEN microseconds.
+    constexpr uint64_t PERIOD_TIMES_DEN = PERIOD_US * static_cast<uint64_t>(SOURCE_CLK_PERIOD_DEN);
+    constexpr uint64_t COUNT_TIMES_DEN = static_cast<uint64_t>(CLK_DIV * SOURCE_CLK_PERIOD_US);
+    static_assert(PERIOD_TIMES_DEN % (COMPARES_PER_PERIOD * COUNT_TIMES_DEN) == 0,
+                  "The trigger period must be a whole number of timer counts (with TIMER0_OUT0 an even number)");
+    constexpr uint16_t COMPARE_VALUE =
+      Timer<0>::calculateCompareValue<CLK_DIV, SOURCE_CLK_PERIOD_US, COMPARE_PERIOD_US, std::chrono::microseconds,
+                                      SOURCE_CLK_PERIOD_DEN>();
+
+    if (trigger == AdcTrigger::SOFTWARE && (TA0CTL & MC_3) != 0) {
+      return false;  // The timer 0 is used by something else, e.g. a Pwm
+    }
+    const bool wasRunning = (ADC10CTL0 & ENC) != 0;
+    stop();
+    Timer<0>::getTimer().init(config);
+    TA0CCR0 = COMPARE_VALUE;
+    switch (TRIGGER) {
+      case AdcTrigger::TIMER0_OUT1:
+        TA0CCR1 = COMPARE_VALUE / 2;
+        TA0CCTL1 = OUTMOD_7;  // Reset at CCR1, set (rising edge) at CCR0
+        break;
+      case AdcTrigger::TIMER0_OUT2:
+        TA0CCR2 = COMPARE_VALUE / 2;
+        TA0CCTL2 = OUTMOD_7;
+        break;
+      default:
+        TA0CCTL0 = OUTMOD_4;  // Toggle at CCR0
+        break;
+    }
+    trigger = TRIGGER;
+    configureMode(wasRunning);
+    setRegisterBits(TA0CTL, static_cast<uint16_t>(MC_1));
+    return true;
+  }
+
+  /**
+   * Method to select the positive reference of the conversions. The default is VCC. If the ADC is running, it
+   * is stopped at the end of the current conversion or sequence and started again with the new reference.
+   * E.g. to measure the supply voltage with the channel 11:
+   *  @code
+   *    AdcHandle halfVcc = Adc::getInstance().getAdcHandle<Adc::HALF_VCC_CHANNEL>();
+   *    Adc::getInstance().setReference(AdcReference::INTERNAL_2V5);
+   *    ...
+   *    const uint16_t vccMillivolts = AdcScale<AdcReference::INTERNAL_2V5>::toVccMillivolts(halfVcc.getRawValue());
+   *  @endcode
+   * @param newReference Reference to be used
+   */
+  void setReference(AdcReference newReference) noexcept {
+    if (newReference == reference) {
+      return;
+    }
+    const bool wasRunning = (ADC10CTL0 & ENC) != 0;
+    stop();
+    reference = newReference;
+    configureMode(wasRunning);
+  }
+
+  AdcReference getReference() const noexcept {
+    return reference;
+  }
+
+  /**
+   * Method to go back to continuous conversions started by software. The timer 0 is stopped.
+   * The registered listeners stay registered, but they are not called until a timer trigger is set again.
+   */
+  void setSoftwareTrigger() noexcept {
+    if (trigger == AdcTrigger::SOFTWARE) {
+      return;
+    }
+    const bool wasRunning = (ADC10CTL0 & ENC) != 0;
+    stop();
+    Timer<0>::getTimer().stop();
+    trigger = AdcTrigger::SOFTWARE;
+    configureMode(wasRunning);
+  }
+
+  /**
+   * Method to stream one channel to a buffer with the two-block mode of the DTC. The buffer is split in two
+   * blocks: while the DTC fills one of them, the other one can be processed. The callbacks are called by the
+   * ADC interrupt when a block is full, so the processing must be finished before the DTC wraps to that block
+   * again. With the software trigger the ADC converts as fast as its clock allows (4.2us per sample), so the
+   * blocks should be large. With setTimerTrigger() the samples are taken at the timer period.
+   *
+   * While streaming, the values of the AdcHandles are not refreshed. The ADC must already be initialized.
+   * E.g.:
+   *  @code
+   *    std::array<uint16_t, 64> oscilloscopeSamples;
+   *    Adc::getInstance().startStreaming<0>(oscilloscopeSamples, &firstHalfReady, &secondHalfReady);
+   *  @endcode
+   *
+   * @tparam CHANNEL Channel to be streamed
+   * @param buffer Buffer with the two blocks. Its size must be even and at most 510 samples.
+   * @param halfCompleted Called when the first half of the buffer is full. Can be nullptr.
+   * @param fullCompleted Called when the second half of the buffer is full. Can be nullptr.
+   */
+  template<uint8_t CHANNEL, std::size_t BUFFER_SIZE>
+  void startStreaming(std::array<uint16_t, BUFFER_SIZE>& buffer, BlockCallback halfCompleted,
+                      BlockCallback fullCompleted) noexcept {
+    static_assert(isValidChannel(CHANNEL), "The ADC channel must be from 0 to 7, 10 or 11");
+    static_assert(BUFFER_SIZE > 0 && (BUFFER_SIZE % 2) == 0 && BUFFER_SIZE / 2 <= 0xFF,
+                  "The stream buffer must have an even size of at most 510 samples");
+    stop();
+    setRegisterBits(ADC10AE0, static_cast<uint8_t>((CHANNEL <= 7) ? (0x01 << CHANNEL) : 0));
+    streamChannel = CHANNEL;
+    streamBuffer = buffer.data();
+    streamBlockSize = BUFFER_SIZE / 2;
+    streamHalfCompleted = halfCompleted;
+    streamFullCompleted = fullCompleted;
+    configureMode(true);
+  }
+
+  /**
+   * Method to stop the streaming mode. The sequence of the AdcHandles is configured and started again.
+   */
+  void stopStreaming() noexcept {
+    if (!isStreaming()) {
+      return;
+    }
+    stop();
+    ADC10CTL0 &= ~(ADC10IE + ADC10IFG);
+    streamBuffer = nullptr;
+    configureMode(true);
+  }
+
+  bool isStreaming() const noexcept {
+    return streamBuffer != nullptr;
+  }
+
+  /**
+   * Method to be called by the ADC10 interrupt.
+   */
+  void interruptionHappened() {
+    ADC10CTL0 &= ~ADC10IFG;
+    if (!isStreaming()) {
+      // The DTC finished a sequence, so every channel has a new value.
+      for (AdcListenerBase* listener = listeners; listener != nullptr; listener = listener->next) {
+        listener->newSample(adcValues[MAX_CHANNEL - listener->channel]);
+      }
+      return;
+    }
+    // ADC10B1 tells which block was just filled. The DTC is already writing the other one.
+    if (ADC10DTC0 & ADC10B1) {
+      if (streamHalfCompleted != nullptr) {
+        streamHalfCompleted(streamBuffer, streamBlockSize);
+      }
+    } else if (streamFullCompleted != nullptr) {
+      streamFullCompleted(streamBuffer + streamBlockSize, streamBlockSize);
+    }
+  }
+
+  /**
+   * Method to retrieve an ADC Handle.
+   * @tparam pinNumber specify pin number of ADC to be retrieved. Can also be TEMPERATURE_CHANNEL or HALF_VCC_CHANNEL
+   * @tparam bitMask Not needed to be filled. There is a default value. The internal channels have no pin
+   * @return The handle of that ADC pin
+   */
+  template<uint8_t pinNumber, uint8_t bitMask = (pinNumber <= 7) ? (0x01 << pinNumber) : 0>
+  AdcHandle getAdcHandle() {
+    static_assert(isValidChannel(pinNumber), "The ADC channel must be from 0 to 7, 10 or 11");
+    requestChannel(pinNumber, bitMask);
+
+    // Creates the AdcHandle and passes the array entry equivalent to the pin to the handle.
+    AdcHandle retVal(adcValues[MAX_CHANNEL - pinNumber]);
+
+    return retVal;
+  }
+
+  /**
+   * Method to register a listener (e.g. a FilteredAdcHandle) to a channel. From then on it gets every new
+   * conversion of the channel in the ADC interrupt. The interrupt comes after every sequence, so the sample
+   * rate must come from setTimerTrigger(), which has to be called before. With the software trigger the
+   * interrupt would come every few tens of microseconds and take most of the CPU, so the registration is
+   * rejected. The listeners are not called in the streaming mode.
+   * @tparam CHANNEL Channel of the listener
+   * @param listener Listener to register. If it is already registered, it is moved to the new channel.
+   * @return true if the listener was registered. False if the ADC uses the software trigger.
+   */
+  template<uint8_t CHANNEL>
+  bool registerListener(AdcListenerBase& listener) noexcept {
+    static_assert(isValidChannel(CHANNEL), "The ADC channel must be from 0 to 7, 10 or 11");
+    if (trigger == AdcTrigger::SOFTWARE) {
+      return false;
+    }
+    deregisterListener(listener);
+    requestChannel(CHANNEL, static_cast<uint8_t>((CHANNEL <= 7) ? (0x01 << CHANNEL) : 0));
+    CriticalSection criticalSection;
+    listener.channel = CHANNEL;
+    listener.next = listeners;
+    listener.isRegistered = true;
+    listeners = &listener;
+    if (!isStreaming()) {
+      setRegisterBits(ADC10CTL0, static_cast<uint16_t>(ADC10IE));
+    }
+    return true;
+  }
+
+  /**
+   * Method to deregister a listener. The channel keeps being converted.
+   */
+  void deregisterListener(AdcListenerBase& listener) noexcept {
+    CriticalSection criticalSection;
+    if (!listener.isRegistered) {
+      return;
+    }
+    AdcListenerBase** previousNext = &listeners;
+    while (*previousNext != &listener) {
+      previousNext = &(*previousNext)->next;
+    }
+    *previousNext = listener.next;
+    listener.next = nullptr;
+    listener.isRegistered = false;
+    if (listeners == nullptr && !isStreaming()) {
+      ADC10CTL0 &= ~ADC10IE;
+    }
+  }
+
+  /**
+   * @return Bit mask of the channels for which a handle was requested.
+   */
+  uint16_t getRequestedChannels() const noexcept {
+    return requestedChannels;
+  }
+
+  /**
+   * @return true if the channel can be converted: the pins A0 to A7 and the internal channels 10 and 11.
+   */
+  static constexpr bool isValidChannel(uint8_t channel) {
+    return channel <= 7 || channel == TEMPERATURE_CHANNEL || channel == HALF_VCC_CHANNEL;
+  }
+
+private:
+  /**
+   * Adds a channel to the sequence and sets its pin as an ADC input.
+   * @param pinMask Bit of the pin in ADC10AE0. 0 for the internal channels
+   */
+  void requestChannel(uint8_t channel, uint8_t pinMask) noexcept {
+    setRegisterBits(ADC10AE0, pinMask);  // Sets pin as an ADC input
+
+    const uint16_t channelBit = 0x01 << channel;
+    if (requestedChannels & channelBit) {
+      return;
+    }
+    // The sequence must start at a new highest channel, and the temperature sensor needs a longer sample time.
+    const bool changesSequence = (channel > getHighestChannel()) || (channel == TEMPERATURE_CHANNEL);
+    requestedChannels |= channelBit;
+    if (isInitialized && !isStreaming() && changesSequence) {
+      reconfigure();  // Channel requested after init
+    }
+  }
+
+  /**
+   * Stops the ADC at the end of the current conversion or sequence and disables the DTC.
+   */
+  static void stop() noexcept {
+    ADC10CTL0 &= ~ENC;
+    while (ADC10CTL1 & ADC10BUSY){}
+    ADC10DTC1 = 0;
+  }
+
+  /**
+   * @return MSC if the conversions follow each other automatically, 0 if each one needs a trigger.
+   */
+  uint16_t getMultipleConversionBit() const noexcept {
+    return (trigger == AdcTrigger::SOFTWARE) ? MSC : 0;
+  }
+
+  /**
+   * @return true if the temperature sensor is converted, in the sequence or in the streaming mode.
+   */
+  bool convertsTemperature() const noexcept {
+    if (isStreaming()) {
+      return streamChannel == TEMPERATURE_CHANNEL;
+    }
+    return (requestedChannels & (0x01 << TEMPERATURE_CHANNEL)) != 0;
+  }
+
+  /**
+   * The temperature sensor needs a sample time of at least 30us (datasheet). Its ADC clock is divided by 4 and
+   * the sample time is 64 cycles = 64*0.8us = 51.2us, which is still more than 30us with the slowest ADC10OSC.
+   * This also applies to the other channels of the sequence, so each channel then takes 61.6us instead of 4.2us.
+   * @return The sample and hold time bits of ADC10CTL0.
+   */
+  uint16_t getSampleTimeBits() const noexcept {
+    return convertsTemperature() ? ADC10SHT_3 : ADC10SHT_1;
+  }
+
+  /**
+   * @return The ADC clock divider bits of ADC10CTL1. See getSampleTimeBits().
+   */
+  uint16_t getClockDividerBits() const noexcept {
+    return convertsTemperature() ? ADC10DIV_3 : ADC10DIV_0;
+  }
+
+  /**
+   * Configures the ADC for the current mode (streaming or sequence), trigger and reference.
+   * Must be called while stopped.
+   * @param restart If true the conversions are started again.
+   */
+  void configureMode(bool restart) noexcept {
+    // ADC10 on, with the reference and sample and hold time of the channels.
+    // Multiple sample and conversion on, unless a timer triggers each conversion.
+    // These bits can only be changed while ENC is reset. The interrupt is enabled again by the mode if needed.
+    ADC10CTL0 = ADC10ON + getSampleTimeBits() + getMultipleConversionBit() + static_cast<uint16_t>(reference);
+    if (isStreaming()) {
+      configureStream();
+    } else {
+      configureScan();
+    }
+    if (restart) {
+      startConversion();
+    }
+  }
+
+  /**
+   * Configures the repeated conversion of the streamed channel and its two-block transfer to the stream buffer.
+   */
+  void configureStream() noexcept {
+    // Repeat-single-channel mode, with the same clock and sample and hold time as the sequence.
+    ADC10CTL1 =
+      CONSEQ_2 + ADC10SSEL_0 + getClockDividerBits() + static_cast<uint16_t>(trigger) + streamChannel * INCH_1;
+    ADC10DTC0 = ADC10TB + ADC10CT;  // Two-block mode, continuous transfer
+    ADC10DTC1 = streamBlockSize;    // Size of each block
+    ADC10CTL0 &= ~ADC10IFG;
+    setRegisterBits(ADC10CTL0, static_cast<uint16_t>(ADC10IE));  // Interrupt when each block is full
+    ADC10SA = (std::size_t)(streamBuffer);
+  }
+
+  /**
+   * Configures the repeated sequence of the requested channels and its transfer to adcValues.
+   */
+  void configureScan() noexcept {
     // Repeat-sequence-of-channels mode
     // CLk source = ADC10OSC => around 5 MHz
     // DTC can take up to 4 MCKL cycles (4 us), so the sample and hold time should be
@@ -85,9 +653,10 @@ public:
     // sample and hold time = 16 ADC Clock cycles = 8*0.2us = 1.6 us
     // Convert time = 13 ADC Clock cycles = 13*0.2us = 2.6us
     // Total conversion of 1 channel = Sample and hold + convert time = 1.6us + 2.6us = 4.2us
-    // Source of sample and hold from ADC10SC bit
-    // Always start sampling from the ADC7, since we are populating the adcValues array with DTC
-    ADC10CTL1 = CONSEQ_3 + ADC10SSEL_0 + ADC10DIV_0 + SHS_0 + INCH_0;
+    // Source of sample and hold from ADC10SC bit or from the timer output unit
+    // The sequence starts at the highest requested channel, since we are populating the adcValues array with DTC
+    ADC10CTL1 = CONSEQ_3 + ADC10SSEL_0 + getClockDividerBits() + static_cast<uint16_t>(trigger) +
+                getHighestChannel() * INCH_1;
 
     // Setup Data transfer control 0
     // The basic idea is that everytime the ADC does a conversion, the
@@ -96,51 +665,68 @@ public:
     // References of the adcValues array are passed to the AdcHandles
     // so when the user gets the AdcHandles, the latest raw value will always be available
     // without the user having to actively fetch any data from the ADC10MEM.
-    ADC10DTC0 = ADC10CT;                                   // enable continuous transfer
-    ADC10DTC1 = 1; //sizeof(adcValues) / sizeof(adcValues[0]);  // Number of transfers is equal to the size of array.
-    ADC10SA = (size_t)(&adcValues[0]);                     // Starts at address is the first entry of the array;
+    ADC10DTC0 = ADC10CT;  // enable continuous transfer
+    if (listeners != nullptr && trigger != AdcTrigger::SOFTWARE) {
+      setRegisterBits(ADC10CTL0, static_cast<uint16_t>(ADC10IE));  // Interrupt after every sequence
+    }
+    configureTransfer();
   }
 
   /**
-   * Method that starts the ADC conversion
-   * Previous to this call, one has to already have requested the ADC handles, as well as
-   * initialized the ADC.
+   * @return The highest requested channel, which is the first channel of the sequence. 0 if none was requested.
    */
-  void startConversion() {
-    setRegisterBits(ADC10CTL0, static_cast<uint16_t>(ADC10SC + ENC));
+  uint8_t getHighestChannel() const noexcept {
+    uint8_t channel = MAX_CHANNEL;
+    while (channel > 0 && (requestedChannels & (0x01 << channel)) == 0) {
+      channel--;
+    }
+    return channel;
   }
 
   /**
-   * Method to retrieve an ADC Handle.
-   * @tparam pinNumber specify pin number of ADC to be retrieved
-   * @tparam bitMask Not needed to be filled. There is a default value
-   * @return The handle of that ADC pin
+   * Sets the DTC block to the channels of the sequence: from the highest requested channel down to A0.
+   * Writing ADC10SA starts the transfer, so it is written last.
    */
-  template<uint8_t pinNumber, uint8_t bitMask = 0x01 << pinNumber>
-  AdcHandle getAdcHandle() {
-    constexpr uint8_t MAX_NUM_ADC_CHANNELS = 7;
-    static_assert(pinNumber <= MAX_NUM_ADC_CHANNELS, "Cannot set ADC to pin higher than 7");
-    setRegisterBits(ADC10AE0, bitMask);  // Sets pin as an ADC input
-
-    // Creates the AdcHandle and passes the array entry equivalent to the pin to the handle.
-    AdcHandle retVal(adcValues[pinNumber]);
+  void configureTransfer() noexcept {
+    const uint8_t highestChannel = getHighestChannel();
+    ADC10DTC1 = highestChannel + 1;
+    ADC10SA = (std::size_t)(&adcValues[MAX_CHANNEL - highestChannel]);
+  }
 
-    return retVal;
+  /**
+   * Stops the ADC at the end of the current sequence, configures the sequence for the requested channels
+   * and starts it again if it was running. INCH and the sample time can only be changed while ENC is reset.
+   */
+  void reconfigure() noexcept {
+    const bool wasRunning = (ADC10CTL0 & ENC) != 0;
+    stop();
+    configureMode(wasRunning);
   }
 
-private:
   /**
-   * Array that stores the conversion values from the ADC.
+   * Array that stores the conversion values from the ADC in descending channel order.
    * It is automatically populated by the DTC
    */
-  std::array<uint16_t, 8> adcValues{0, 0, 0, 0, 0, 0, 0, 0};
+  std::array<volatile uint16_t, MAX_CHANNEL + 1> adcValues{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  uint16_t requestedChannels = 0;  ///< Bit mask of the channels with a handle
+  AdcListenerBase* listeners = nullptr;  ///< List of the registered listeners
+  bool isInitialized = false;
+  AdcTrigger trigger = AdcTrigger::SOFTWARE;   ///< Source that starts the conversions
+  AdcReference reference = AdcReference::VCC;  ///< Positive reference of the conversions
+  uint8_t streamChannel = 0;                   ///< Channel of the streaming mode
+  uint16_t* streamBuffer = nullptr;            ///< Buffer of the streaming mode. nullptr when not streaming
+  uint8_t streamBlockSize = 0;                 ///< Number of samples of each block of the stream buffer
+  BlockCallback streamHalfCompleted = nullptr;
+  BlockCallback streamFullCompleted = nullptr;
 };
 }  // namespace Microtech
 
+#ifndef MICROTECH_CUSTOM_ADC10_ISR
 // ADC10 Interruption
-// #pragma vector = ADC10_VECTOR
-//__interrupt void ADC10_ISR(void) {
-//  Microtech::Adc::getInstance().interruptionHappened();
-//}
+#pragma vector = ADC10_VECTOR
+__interrupt void ADC10_ISR(void) {
+  Microtech::Adc::getInstance().interruptionHappened();
+}
+#endif
 
 #endif  // MICROTECH_ADC_HPP
@@ -0,0 +1,142 @@
+#ifndef MICROTECH_ADCFILTERS_HPP
+#define MICROTECH_ADCFILTERS_HPP
+
+#include "MovingAverage.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace Microtech {
+
+/**
+ * Filter that oversamples and decimates the ADC samples to get more effective resolution.
+ * It sums 4^OVERSAMPLING_BITS samples and shifts the sum right by OVERSAMPLING_BITS, so every output has
+ * OVERSAMPLING_BITS more bits than the 10 bits of the ADC, at a rate 4^OVERSAMPLING_BITS times lower.
+ * The extra bits are only meaningful if the input has at least 1 LSB of noise (dither), which is usually the case.
+ * E.g. Decimator<2> gives a 12 bits value out of 16 samples.
+ *
+ * The sum of 64 samples of 10 bits still fits in 16 bits, so it is only additions and one shift.
+ *
+ * @tparam OVERSAMPLING_BITS Number of extra bits of resolution, from 1 to 3.
+ */
+template<uint8_t OVERSAMPLING_BITS>
+class Decimator {
+  static_assert(OVERSAMPLING_BITS >= 1 && OVERSAMPLING_BITS <= 3, "The Decimator supports 1 to 3 extra bits");
+
+public:
+  static constexpr uint8_t NUM_SAMPLES = 1U << (2 * OVERSAMPLING_BITS);  ///< Samples summed for each output
+  static constexpr uint8_t OUTPUT_BITS = 10 + OVERSAMPLING_BITS;         ///< Resolution of the outputs
+
+  /**
+   * Adds a sample to the sum.
+   * @param sample New sample. It is replaced by the decimated value when there is an output.
+   * @return true if NUM_SAMPLES were summed and the sample holds a new output.
+   */
+  bool processSample(uint16_t& sample) noexcept {
+    sum += sample;
+    if (++numSamples < NUM_SAMPLES) {
+      return false;
+    }
+    sample = sum >> OVERSAMPLING_BITS;
+    sum = 0;
+    numSamples = 0;
+    return true;
+  }
+
+private:
+  uint16_t sum = 0;        ///< Sum of the samples of the current output
+  uint8_t numSamples = 0;  ///< Number of samples in the sum
+};
+
+/**
+ * Filter stage with a simple moving average over the last NUM_SAMPLES samples.
+ * @tparam NUM_SAMPLES Number of samples of the average. A power of two makes the division a shift.
+ */
+template<uint8_t NUM_SAMPLES>
+class Sma {
+public:
+  bool processSample(uint16_t& sample) noexcept {
+    sample = average.filterNewSample(sample);
+    return true;
+  }
+
+private:
+  SimpleMovingAverage<NUM_SAMPLES> average;
+};
+
+/**
+ * Filter stage with a median over the last NUM_SAMPLES samples. It removes spikes without smoothing the edges.
+ * The window is also kept sorted, so each sample costs NUM_SAMPLES comparisons at most and no sorting.
+ * @tparam NUM_SAMPLES Number of samples of the window. Must be odd.
+ */
+template<uint8_t NUM_SAMPLES>
+class Median {
+  static_assert(NUM_SAMPLES % 2 == 1, "The window of the median must have an odd number of samples");
+
+public:
+  bool processSample(uint16_t& sample) noexcept {
+    const uint16_t oldestSample = window[index];
+    window[index] = sample;
+    if (++index == NUM_SAMPLES) {
+      index = 0;
+    }
+
+    // Replaces the oldest sample by the new one in the sorted window and moves it to its place.
+    uint8_t position = 0;
+    while (sortedWindow[position] != oldestSample) {
+      position++;
+    }
+    sortedWindow[position] = sample;
+    while (position > 0 && sortedWindow[position - 1] > sortedWindow[position]) {
+      std::swap(sortedWindow[position - 1], sortedWindow[position]);
+      position--;
+    }
+    while (position < NUM_SAMPLES - 1 && sortedWindow[position + 1] < sortedWindow[position]) {
+      std::swap(sortedWindow[position + 1], sortedWindow[position]);
+      position++;
+    }
+    sample = sortedWindow[NUM_SAMPLES / 2];
+    return true;
+  }
+
+private:
+  uint8_t index = 0;                                 ///< Position of the oldest sample in the window
+  std::array<uint16_t, NUM_SAMPLES> window{};        ///< Last samples in the order they came
+  std::array<uint16_t, NUM_SAMPLES> sortedWindow{};  ///< Last samples sorted
+};
+
+/**
+ * Chain of filter stages, applied in order. A stage that gives no output (e.g. a Decimator waiting for
+ * more samples) stops the chain, so the next stages run at its output rate. E.g.:
+ *  @code
+ *    FilteredAdcHandle<Chain<Median<5>, Sma<16>>> ldr;  // Removes the spikes and then smooths
+ *  @endcode
+ * The stages are resolved in compile time, so there is no call through a pointer.
+ */
+template<typename... Stages>
+class Chain;
+
+template<>
+class Chain<> {
+public:
+  bool processSample(uint16_t& /*sample*/) noexcept {
+    return true;
+  }
+};
+
+template<typename Stage, typename... Stages>
+class Chain<Stage, Stages...> {
+public:
+  bool processSample(uint16_t& sample) noexcept {
+    return stage.processSample(sample) && nextStages.processSample(sample);
+  }
+
+private:
+  Stage stage;
+  Chain<Stages...> nextStages;
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_ADCFILTERS_HPP
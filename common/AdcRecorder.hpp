@@ -0,0 +1,282 @@
+#ifndef MICROTECH_ADCRECORDER_HPP
+#define MICROTECH_ADCRECORDER_HPP
+
+#include "Adc.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Sample of an ADC channel with the time it was received.
+ */
+struct AdcRecord {
+  uint32_t timestamp;  ///< Time of the ADC interrupt in clock counts (see UptimeClock::nowCounts())
+  uint16_t sample;     ///< Value of the channel
+};
+
+/**
+ * Listener that records the samples of a channel with their timestamps in a ring buffer, so bursts can be
+ * inspected after the fact and sent in bulk by the main loop instead of sample by sample.
+ *
+ * The recorder has two modes:
+ *  - Streaming (startStreaming()): the ADC interrupt appends every record and the main loop reads them.
+ *    When the buffer is full the new records are dropped and counted in getNumDroppedRecords().
+ *  - Capture (arm()): the ADC interrupt keeps overwriting the oldest records, so the buffer always holds the
+ *    latest history. When the trigger condition is met, it still records the post-trigger records and then
+ *    freezes the buffer. The main loop then reads the capture: the history before the trigger, the trigger
+ *    record and the records after it.
+ *
+ * It is a single-producer/single-consumer ring buffer. The producer is the ADC interrupt and the consumer is
+ * the main loop. Like in the DeferredQueue, each side only writes its own index, so no interrupt has to be
+ * disabled to read the records. In the capture mode the interrupt owns the buffer until it is frozen.
+ * E.g. to capture the 48 samples before and the 16 samples after a rising edge through 512:
+ *  @code
+ *    using Clock = UptimeClock<1, 8, 1>;
+ *    AdcRecorder<6, Clock> recorder;  // 64 records
+ *
+ *    Adc::getInstance().setTimerTrigger<AdcTrigger::TIMER0_OUT0, 250>(ADC_TIMER_CONFIG);  // 4kHz
+ *    Adc::getInstance().registerListener<0>(recorder);
+ *    recorder.arm(512, true, 16);
+ *    ...
+ *    if (recorder.isCaptured()) {
+ *      const AdcRecord* records = nullptr;
+ *      uint8_t numRecords;
+ *      while ((numRecords = recorder.peek(records)) > 0) {
+ *        sendRecords(records, numRecords);
+ *        recorder.release(numRecords);
+ *      }
+ *      recorder.arm(512, true, 16);
+ *    }
+ *  @endcode
+ *
+ * @tparam CAPACITY_BITS Capacity of the buffer as a power of two, from 1 to 7 (2 to 128 records).
+ * @tparam Clock Source of the timestamps. Any class with a static uint32_t nowCounts(), e.g. UptimeClock.
+ * @tparam Filter Optional filter applied to the samples before they are recorded (see FilteredAdcHandle).
+ */
+template<uint8_t CAPACITY_BITS, typename Clock, typename Filter = Chain<>>
+class AdcRecorder : public AdcListenerBase {
+  static_assert(CAPACITY_BITS >= 1 && CAPACITY_BITS <= 7, "The AdcRecorder can hold from 2 to 128 records");
+
+public:
+  static constexpr uint8_t CAPACITY = 1U << CAPACITY_BITS;  ///< Number of records of the buffer
+
+  AdcRecorder() = default;
+
+  /**
+   * Starts the streaming mode. The records of the previous mode are discarded.
+   */
+  void startStreaming() noexcept {
+    CriticalSection criticalSection;
+    head = 0;
+    tail = 0;
+    state = State::STREAMING;
+  }
+
+  /**
+   * Starts the capture mode. The records of the previous mode are discarded.
+   * @param level Level of the trigger
+   * @param risingEdge If true the trigger is a sample >= level after a sample < level. Otherwise the other way around
+   * @param numPostTriggerRecords Records after the trigger record. The rest of the buffer holds the history
+   *                              before the trigger. Must be smaller than CAPACITY.
+   */
+  void arm(uint16_t level, bool risingEdge, uint8_t numPostTriggerRecords) noexcept {
+    CriticalSection criticalSection;
+    head = 0;
+    tail = 0;
+    numRecords = 0;
+    triggerLevel = level;
+    triggerOnRisingEdge = risingEdge;
+    postTriggerRecords = (numPostTriggerRecords < CAPACITY) ? numPostTriggerRecords : CAPACITY - 1;
+    forceTrigger = false;
+    isFirstSample = true;
+    state = State::ARMED;
+  }
+
+  /**
+   * Triggers the capture with the next sample, regardless of its value (e.g. after a button press).
+   */
+  void trigger() noexcept {
+    forceTrigger = true;
+  }
+
+  /**
+   * Stops recording. The records of the streaming mode or of a complete capture that were not read yet can
+   * still be read. An incomplete capture is discarded.
+   */
+  void stop() noexcept {
+    CriticalSection criticalSection;
+    if (state == State::ARMED || state == State::TRIGGERED) {
+      tail = head;
+    }
+    state = State::STOPPED;
+  }
+
+  /**
+   * @return true if a capture is complete and can be read.
+   */
+  bool isCaptured() const noexcept {
+    return state == State::CAPTURED;
+  }
+
+  /**
+   * @return Number of records that can be read. 0 while a capture is not complete.
+   */
+  uint8_t getNumAvailable() const noexcept {
+    if (!isReadable()) {
+      return 0;
+    }
+    return static_cast<uint8_t>(head - tail);
+  }
+
+  /**
+   * Gives the oldest records that are contiguous in the buffer, so they can be sent in bulk without a copy.
+   * The records stay valid until they are released.
+   * @param records Set to the oldest record
+   * @return Number of contiguous records. The rest comes after the buffer wraps, with the next call.
+   */
+  uint8_t peek(const AdcRecord*& records) const noexcept {
+    const uint8_t numAvailable = getNumAvailable();
+    const uint8_t index = tail & INDEX_MASK;
+    records = &buffer[index];
+    const uint8_t numUntilWrap = CAPACITY - index;
+    return (numAvailable < numUntilWrap) ? numAvailable : numUntilWrap;
+  }
+
+  /**
+   * Frees the records given by peek().
+   * @param numReleased Number of records that were processed
+   */
+  void release(uint8_t numReleased) noexcept {
+    const uint8_t numAvailable = getNumAvailable();
+    tail = tail + ((numReleased < numAvailable) ? numReleased : numAvailable);
+  }
+
+  /**
+   * Reads the oldest record.
+   * @return true if a record was read. False if there was none.
+   */
+  bool read(AdcRecord& record) noexcept {
+    if (getNumAvailable() == 0) {
+      return false;
+    }
+    record = buffer[tail & INDEX_MASK];
+    tail = tail + 1;  // Frees the entry only after it was copied
+    return true;
+  }
+
+  /**
+   * @return Timestamp of the record that met the trigger condition of the last capture.
+   */
+  uint32_t getTriggerTimestamp() const noexcept {
+    return triggerTimestamp;
+  }
+
+  /**
+   * @return Number of records dropped in the streaming mode because the buffer was full. It saturates.
+   */
+  uint16_t getNumDroppedRecords() const noexcept {
+    return numDroppedRecords;
+  }
+
+private:
+  enum class State : uint8_t {
+    STOPPED,    ///< Nothing is recorded
+    STREAMING,  ///< Every record is appended if there is space
+    ARMED,      ///< Records overwrite the oldest ones until the trigger condition is met
+    TRIGGERED,  ///< Records overwrite the oldest ones until the post-trigger records are complete
+    CAPTURED,   ///< The capture is frozen and belongs to the main loop
+  };
+
+  static constexpr uint8_t INDEX_MASK = CAPACITY - 1;
+
+  bool isReadable() const noexcept {
+    return state == State::STREAMING || state == State::CAPTURED || state == State::STOPPED;
+  }
+
+  void newSample(uint16_t sample) override {
+    if (!filter.processSample(sample)) {
+      return;
+    }
+    switch (state) {
+      case State::STREAMING: stream(sample); break;
+      case State::ARMED:
+      case State::TRIGGERED: capture(sample); break;
+      default: break;
+    }
+  }
+
+  void stream(uint16_t sample) noexcept {
+    const uint8_t currentHead = head;
+    if (static_cast<uint8_t>(currentHead - tail) >= CAPACITY) {
+      if (numDroppedRecords < UINT16_MAX) {
+        numDroppedRecords++;
+      }
+      return;
+    }
+    buffer[currentHead & INDEX_MASK] = AdcRecord{Clock::nowCounts(), sample};
+    head = currentHead + 1;  // Only published after the record is written
+  }
+
+  /**
+   * Overwrites the oldest record. When the capture is complete, the tail is moved to the oldest record and
+   * the buffer is handed over to the main loop.
+   */
+  void capture(uint16_t sample) noexcept {
+    const uint32_t timestamp = Clock::nowCounts();
+    buffer[head & INDEX_MASK] = AdcRecord{timestamp, sample};
+    head = head + 1;
+    if (numRecords < CAPACITY) {
+      numRecords++;
+    }
+
+    if (state == State::ARMED) {
+      if (isTriggerCondition(sample)) {
+        triggerTimestamp = timestamp;
+        remainingRecords = postTriggerRecords;
+        state = State::TRIGGERED;
+      }
+    } else {
+      remainingRecords--;
+    }
+    if (state == State::TRIGGERED && remainingRecords == 0) {
+      tail = head - numRecords;
+      state = State::CAPTURED;  // Only published after the tail is set
+    }
+  }
+
+  bool isTriggerCondition(uint16_t sample) noexcept {
+    const bool isAboveLevel = sample >= triggerLevel;
+    const bool isEdge = !isFirstSample && (isAboveLevel != wasAboveLevel) && (isAboveLevel == triggerOnRisingEdge);
+    wasAboveLevel = isAboveLevel;
+    isFirstSample = false;
+    if (forceTrigger) {
+      forceTrigger = false;
+      return true;
+    }
+    return isEdge;
+  }
+
+  Filter filter;
+  std::array<AdcRecord, CAPACITY> buffer{};  ///< Ring buffer with the records
+  volatile uint8_t head = 0;  ///< Free running index of the next record to write. Written by the producer
+  volatile uint8_t tail = 0;  ///< Free running index of the next record to read. Written by the consumer
+  volatile State state = State::STOPPED;
+  volatile uint16_t numDroppedRecords = 0;  ///< Records dropped in the streaming mode because the buffer was full
+
+  // Capture mode. Only accessed by the interrupt while armed.
+  uint8_t numRecords = 0;          ///< Records in the buffer, up to CAPACITY
+  uint8_t postTriggerRecords = 0;  ///< Records to be recorded after the trigger record
+  uint8_t remainingRecords = 0;    ///< Post-trigger records still to be recorded
+  uint16_t triggerLevel = 0;
+  bool triggerOnRisingEdge = true;
+  bool isFirstSample = true;  ///< The first sample cannot be an edge
+  bool wasAboveLevel = false;
+  volatile bool forceTrigger = false;  ///< Set by trigger()
+  volatile uint32_t triggerTimestamp = 0;
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_ADCRECORDER_HPP
@@ -0,0 +1,146 @@
+#ifndef MICROTECH_ADCSCALE_HPP
+#define MICROTECH_ADCSCALE_HPP
+
+#include "Adc.hpp"
+
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Conversion of the ADC values to physical units with fixed-point scale factors. The factors are calculated in
+ * compile time for the reference, so each conversion is one multiplication, an addition and a shift, without
+ * float math or divisions. E.g.:
+ *  @code
+ *    using Scale = AdcScale<AdcReference::INTERNAL_1V5>;
+ *    const uint16_t millivolts = Scale::toMillivolts(sensor.getRawValue());
+ *    const int16_t deciCelsius = Scale::toDeciCelsius(temperature.getRawValue());  // 235 is 23.5 degrees
+ *  @endcode
+ *
+ * @tparam REFERENCE Reference of the conversions, as given to Adc::setReference()
+ * @tparam VCC_MILLIVOLTS Supply voltage. Only used with the VCC reference.
+ */
+template<AdcReference REFERENCE, uint16_t VCC_MILLIVOLTS = 3300>
+class AdcScale {
+  static constexpr uint8_t FRACTIONAL_BITS = 16;
+  static constexpr uint32_t HALF = 1UL << (FRACTIONAL_BITS - 1);  ///< Used for rounding
+  static constexpr uint16_t FULL_SCALE = 1023;                     ///< Value of the ADC at the reference
+
+  static constexpr uint16_t getReferenceMillivolts() {
+    return (REFERENCE == AdcReference::INTERNAL_1V5)   ? 1500
+           : (REFERENCE == AdcReference::INTERNAL_2V5) ? 2500
+                                                       : VCC_MILLIVOLTS;
+  }
+
+  /// Typical values of the temperature sensor from the datasheet: V = 3.55mV/C * T + 986mV
+  static constexpr int64_t SENSOR_MICROVOLTS_PER_DEGREE = 3550;
+  static constexpr int64_t SENSOR_MILLIVOLTS_AT_0C = 986;
+
+  /// Millivolts of one count in Q16
+  static constexpr uint32_t MILLIVOLTS_PER_COUNT =
+    ((static_cast<uint32_t>(getReferenceMillivolts()) << FRACTIONAL_BITS) + FULL_SCALE / 2) / FULL_SCALE;
+  /// Tenths of a degree of one count in Q16
+  static constexpr int32_t DECI_CELSIUS_PER_COUNT = static_cast<int32_t>(
+    (static_cast<int64_t>(getReferenceMillivolts()) * 10000 * (1L << FRACTIONAL_BITS)) /
+    (FULL_SCALE * SENSOR_MICROVOLTS_PER_DEGREE));
+  /// Tenths of a degree of the sensor voltage at 0 degrees in Q16
+  static constexpr int32_t DECI_CELSIUS_OFFSET = static_cast<int32_t>(
+    (SENSOR_MILLIVOLTS_AT_0C * 10000 * (1L << FRACTIONAL_BITS)) / SENSOR_MICROVOLTS_PER_DEGREE);
+
+public:
+  AdcScale() = delete;
+
+  static constexpr uint16_t REFERENCE_MILLIVOLTS = getReferenceMillivolts();
+
+  /**
+   * @param value Value of the ADC
+   * @return The voltage at the input in millivolts, rounded.
+   */
+  static constexpr uint16_t toMillivolts(uint16_t value) {
+    return static_cast<uint16_t>((value * MILLIVOLTS_PER_COUNT + HALF) >> FRACTIONAL_BITS);
+  }
+
+  /**
+   * The channel 11 converts (VCC - VSS) / 2, so VCC can be measured up to twice the reference.
+   * Use INTERNAL_2V5 for supplies above 3V.
+   * @param value Value of the channel 11 (Adc::HALF_VCC_CHANNEL)
+   * @return The supply voltage in millivolts, rounded.
+   */
+  static constexpr uint16_t toVccMillivolts(uint16_t value) {
+    return static_cast<uint16_t>((value * (2 * MILLIVOLTS_PER_COUNT) + HALF) >> FRACTIONAL_BITS);
+  }
+
+  /**
+   * Converts the temperature sensor with the typical values of the datasheet. The offset of each device may
+   * differ by a few degrees. Use AdcTemperatureCalibration for the calibrated value.
+   * @param value Value of the channel 10 (Adc::TEMPERATURE_CHANNEL)
+   * @return The temperature in tenths of a degree Celsius.
+   */
+  static constexpr int16_t toDeciCelsius(uint16_t value) {
+    // The shift of a negative value is arithmetic on the MSP430 compilers.
+    return static_cast<int16_t>((value * DECI_CELSIUS_PER_COUNT - DECI_CELSIUS_OFFSET + static_cast<int32_t>(HALF)) >>
+                                FRACTIONAL_BITS);
+  }
+};
+
+/**
+ * Conversion of the temperature sensor with the calibration values of the device. The factory writes the
+ * values of the sensor at 30 and 85 degrees (with the 1.5V reference) to the information memory, so the
+ * sensor must be converted with AdcReference::INTERNAL_1V5. The scale factor is calculated once when the
+ * calibration is created, so each conversion is still one multiplication, an addition and a shift. E.g.:
+ *  @code
+ *    const AdcTemperatureCalibration calibration = AdcTemperatureCalibration::fromInformationMemory();
+ *    if (calibration.isValid()) {
+ *      const int16_t deciCelsius = calibration.toDeciCelsius(temperature.getRawValue());
+ *    }
+ *  @endcode
+ */
+class AdcTemperatureCalibration {
+  static constexpr uint8_t FRACTIONAL_BITS = 16;
+
+public:
+  /**
+   * @param calibrationAt30Degrees Value of the sensor at 30 degrees
+   * @param calibrationAt85Degrees Value of the sensor at 85 degrees
+   */
+  constexpr AdcTemperatureCalibration(uint16_t calibrationAt30Degrees, uint16_t calibrationAt85Degrees)
+    : valueAt30Degrees(calibrationAt30Degrees),
+      deciCelsiusPerCount((calibrationAt85Degrees > calibrationAt30Degrees)
+                            ? (550L << FRACTIONAL_BITS) / (calibrationAt85Degrees - calibrationAt30Degrees)
+                            : 0) {}
+
+  /**
+   * Reads the calibration values from the ADC10 TLV structure of the information memory.
+   */
+  static AdcTemperatureCalibration fromInformationMemory() noexcept {
+    const volatile uint8_t* tlv = &TLV_ADC10_1_TAG;
+    return AdcTemperatureCalibration(*reinterpret_cast<const volatile uint16_t*>(tlv + CAL_ADC_15T30),
+                                     *reinterpret_cast<const volatile uint16_t*>(tlv + CAL_ADC_15T85));
+  }
+
+  /**
+   * @return false if the calibration values are not plausible, e.g. if the information memory was erased.
+   */
+  constexpr bool isValid() const {
+    return deciCelsiusPerCount != 0;
+  }
+
+  /**
+   * @param value Value of the channel 10 (Adc::TEMPERATURE_CHANNEL) with the 1.5V reference
+   * @return The temperature in tenths of a degree Celsius.
+   */
+  constexpr int16_t toDeciCelsius(uint16_t value) const {
+    const int32_t countsAbove30Degrees = static_cast<int32_t>(value) - valueAt30Degrees;
+    return static_cast<int16_t>(
+      300 + ((countsAbove30Degrees * deciCelsiusPerCount + (1L << (FRACTIONAL_BITS - 1))) >> FRACTIONAL_BITS));
+  }
+
+private:
+  uint16_t valueAt30Degrees;    ///< Value of the sensor at 30 degrees
+  int32_t deciCelsiusPerCount;  ///< Tenths of a degree of one count in Q16. 0 if the calibration is not valid
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_ADCSCALE_HPP
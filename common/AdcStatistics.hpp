@@ -0,0 +1,151 @@
+#ifndef MICROTECH_ADCSTATISTICS_HPP
+#define MICROTECH_ADCSTATISTICS_HPP
+
+#include "Adc.hpp"
+#include "helpers.hpp"
+
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Statistics of one window of samples of an ADC channel. The values are in ADC counts.
+ */
+struct AdcStatisticsSnapshot {
+  uint16_t min = 0;       ///< Smallest sample
+  uint16_t max = 0;       ///< Biggest sample
+  uint16_t mean = 0;      ///< Mean, rounded to the nearest count
+  uint32_t variance = 0;  ///< Population variance in counts^2. The square root gives the noise (standard deviation)
+};
+
+/**
+ * Listener that keeps the statistics of a channel over consecutive windows of 2^WINDOW_BITS samples, e.g. to
+ * log the health of a sensor. It is fed with every conversion in the ADC interrupt, so the raw samples are not
+ * buffered. At the end of every window the sums are published and a periodic telemetry task reads the
+ * statistics in O(1). E.g.:
+ *  @code
+ *    AdcStatistics<8> ntcStatistics;  // Windows of 256 samples
+ *    Adc::getInstance().setTimerTrigger<AdcTrigger::TIMER0_OUT0, 1, std::chrono::milliseconds>(ADC_TIMER_CONFIG);
+ *    Adc::getInstance().registerListener<5>(ntcStatistics);
+ *    ...
+ *    const AdcStatisticsSnapshot snapshot = ntcStatistics.getSnapshot();
+ *  @endcode
+ *
+ * Instead of the floating point update of Welford, the sum and the sum of squares are accumulated with
+ * integers, which is exact. Each sample costs a 16x16 bit multiplication and a few 32 bits additions and
+ * comparisons in the interrupt. The sum of squares needs up to 48 bits, so its carry goes to a 16 bits high word.
+ * The mean and the variance need 64 bits and are calculated by getSnapshot(), outside of the interrupt. Since the
+ * window is a power of two, their divisions are shifts.
+ *
+ * @tparam WINDOW_BITS Size of the window as a power of two, from 1 to 16. The sum of a window must fit in
+ *                     32 bits, which is always the case for samples of up to 16 bits - WINDOW_BITS bits.
+ * @tparam Filter Optional filter applied to the samples before the statistics (see FilteredAdcHandle).
+ */
+template<uint8_t WINDOW_BITS, typename Filter = Chain<>>
+class AdcStatistics : public AdcListenerBase {
+  static_assert(WINDOW_BITS >= 1 && WINDOW_BITS <= 16, "The window must have from 2 to 65536 samples");
+
+public:
+  static constexpr uint32_t WINDOW_SIZE = 1UL << WINDOW_BITS;  ///< Number of samples of each window
+
+  AdcStatistics() noexcept {
+    startWindow();
+  }
+
+  /**
+   * Calculates the statistics of the last complete window: mean = sum / N and
+   * variance = (sumOfSquares - sum^2 / N) / N. The sums are copied under the lock and the calculation runs after it.
+   * @return The statistics of the last complete window.
+   */
+  AdcStatisticsSnapshot getSnapshot() const noexcept {
+    WindowSums sums;
+    {
+      CriticalSection criticalSection;
+      sums = publishedSums;
+    }
+    AdcStatisticsSnapshot snapshot;
+    snapshot.min = sums.min;
+    snapshot.max = sums.max;
+    snapshot.mean = static_cast<uint16_t>((sums.sum + (WINDOW_SIZE / 2)) >> WINDOW_BITS);
+    const uint64_t sumOfSquares = (static_cast<uint64_t>(sums.sumOfSquaresHigh) << 32) + sums.sumOfSquares;
+    const uint64_t squareOfSumPerSample = (static_cast<uint64_t>(sums.sum) * sums.sum) >> WINDOW_BITS;
+    snapshot.variance = static_cast<uint32_t>((sumOfSquares - squareOfSumPerSample) >> WINDOW_BITS);
+    return snapshot;
+  }
+
+  /**
+   * @return Number of complete windows since the start. It saturates.
+   */
+  uint16_t getNumWindows() const noexcept {
+    return numWindows;
+  }
+
+  /**
+   * Discards the samples of the current window. The last snapshot is kept.
+   */
+  void restartWindow() noexcept {
+    CriticalSection criticalSection;
+    startWindow();
+  }
+
+private:
+  /**
+   * Sums of one window. The sum of squares is split in a low and a high word, so that the interrupt only adds
+   * 32 bits values.
+   */
+  struct WindowSums {
+    uint16_t min = 0;               ///< Smallest sample
+    uint16_t max = 0;               ///< Biggest sample
+    uint32_t sum = 0;               ///< Sum of the samples
+    uint32_t sumOfSquares = 0;      ///< Low 32 bits of the sum of the squares of the samples
+    uint16_t sumOfSquaresHigh = 0;  ///< High 16 bits of the sum of the squares of the samples
+  };
+
+  void newSample(uint16_t sample) override {
+    if (!filter.processSample(sample)) {
+      return;
+    }
+    if (sample < current.min) {
+      current.min = sample;
+    }
+    if (sample > current.max) {
+      current.max = sample;
+    }
+    const uint32_t square = static_cast<uint32_t>(sample) * sample;
+    current.sum += sample;
+    current.sumOfSquares += square;
+    if (current.sumOfSquares < square) {
+      current.sumOfSquaresHigh++;  // Carry of the low word
+    }
+    if (++numSamples == WINDOW_SIZE) {
+      publishWindow();
+    }
+  }
+
+  /**
+   * Publishes the sums of the complete window. The statistics are calculated by getSnapshot().
+   */
+  void publishWindow() noexcept {
+    publishedSums = current;
+    if (numWindows < UINT16_MAX) {
+      numWindows++;
+    }
+    startWindow();
+  }
+
+  void startWindow() noexcept {
+    numSamples = 0;
+    current = WindowSums();
+    current.min = UINT16_MAX;
+  }
+
+  Filter filter;
+  uint32_t numSamples = 0;   ///< Samples of the current window
+  WindowSums current;        ///< Sums of the current window
+  WindowSums publishedSums;  ///< Sums of the last complete window
+  volatile uint16_t numWindows = 0;
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_ADCSTATISTICS_HPP
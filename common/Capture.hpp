@@ -0,0 +1,240 @@
+#ifndef MICROTECH_CAPTURE_HPP
+#define MICROTECH_CAPTURE_HPP
+
+#include "helpers.hpp"
+
+#include <msp430g2553.h>
+#include <array>
+#include <cstdint>
+#include <ratio>
+
+namespace Microtech {
+
+/**
+ * Edges of the input signal that are captured.
+ */
+enum class CaptureEdge {
+  RISING,   ///< Only the period is measured, between rising edges
+  FALLING,  ///< Only the period is measured, between falling edges
+  BOTH,     ///< Period and pulse width (high time) are measured
+};
+
+/**
+ * One measurement of the captured input. All values are in timer counts.
+ */
+struct CaptureMeasurement {
+  uint16_t timestamp = 0;   ///< Counter value of the edge that completed the measurement
+  uint16_t period = 0;      ///< Counts between this edge and the previous edge in the same direction
+  uint16_t pulseWidth = 0;  ///< Counts the input stayed high during the period. Only with CaptureEdge::BOTH
+};
+
+/**
+ * Class that serves as a base for a Capture, in the same way TaskHandlerBase serves for TaskHandler.
+ * The timer stores the pointer of this class per capture/compare channel and calls it from its interrupt.
+ *
+ * The timer hardware copies the counter into the channel register at the edge, so the measurement does
+ * not depend on the interrupt latency. Every complete measurement is passed to the callback (in the interrupt)
+ * and written to a ring buffer that the main loop reads with read().
+ */
+class CaptureHandlerBase {
+  template<uint8_t TIMER_NUMBER>
+  friend class Timer;
+
+public:
+  typedef void (*CallbackFunction)(const CaptureMeasurement& measurement);  ///< Type definition of the callback
+
+  CaptureHandlerBase(const CaptureHandlerBase&) = delete;
+  CaptureHandlerBase& operator=(const CaptureHandlerBase&) = delete;
+
+  /**
+   * Method to read the oldest measurement of the ring buffer. Intended to be called from the main loop.
+   * @param measurement Reference where the measurement is written to
+   * @return true if there was a measurement. False if the buffer is empty.
+   */
+  bool read(CaptureMeasurement& measurement) noexcept {
+    const uint8_t currentTail = tail;
+    if (currentTail == head) {
+      return false;
+    }
+    measurement = buffer[currentTail & bufferMask];
+    tail = currentTail + 1;
+    return true;
+  }
+
+  /**
+   * @return The last complete measurement.
+   */
+  CaptureMeasurement getLastMeasurement() const noexcept {
+    CriticalSection criticalSection;
+    return lastMeasurement;
+  }
+
+  /**
+   * @return Number of measurements dropped because the ring buffer was full, plus the edges lost because
+   *         a second capture happened before the first one was served.
+   */
+  uint16_t getNumLostMeasurements() const noexcept {
+    return numLostMeasurements;
+  }
+
+protected:
+  CaptureHandlerBase(CallbackFunction callback, CaptureEdge edge, CaptureMeasurement* buffer, uint8_t bufferMask)
+    : callback(callback), edge(edge), buffer(buffer), bufferMask(bufferMask) {}
+
+private:
+  /**
+   * @return The capture mode bits of the CCTLx register for the edge.
+   */
+  uint16_t getCaptureModeBits() const noexcept {
+    switch (edge) {
+      case CaptureEdge::RISING: return CM_1;
+      case CaptureEdge::FALLING: return CM_2;
+      case CaptureEdge::BOTH: return CM_3;
+    }
+    return CM_3;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  /**
+   * Restarts the measurement. Called by the timer when the capture is registered.
+   */
+  void reset() noexcept {
+    numEdges = 0;
+    fallingEdgeCaptured = false;
+    head = 0;
+    tail = 0;
+  }
+
+  /**
+   * Called by the timer interrupt with the captured counter value.
+   * @param captureValue Value of the CCRx register
+   * @param inputHigh State of the input when the interrupt is served. With CaptureEdge::BOTH it tells
+   *                  which edge was captured, so pulses must be longer than the interrupt latency.
+   * @param edgeLost The hardware signaled that a capture was overwritten before it was read
+   */
+  void captureHappened(uint16_t captureValue, bool inputHigh, bool edgeLost) {
+    if (edgeLost) {
+      numLostMeasurements++;
+      numEdges = 0;  // The edge sequence is broken, start again
+    }
+    if (edge == CaptureEdge::BOTH && !inputHigh) {
+      fallingEdgeValue = captureValue;  // Pulse width is completed at the next rising edge
+      fallingEdgeCaptured = true;
+      return;
+    }
+
+    const uint16_t previousEdgeValue = edgeValue;
+    edgeValue = captureValue;
+    const bool pulseComplete = fallingEdgeCaptured && numEdges > 0;
+    fallingEdgeCaptured = false;
+    if (numEdges < 2) {
+      numEdges++;
+    }
+    if (numEdges < 2) {
+      return;  // The first edge has nothing to be compared with
+    }
+
+    CaptureMeasurement measurement;
+    measurement.timestamp = captureValue;
+    measurement.period = captureValue - previousEdgeValue;
+    if (pulseComplete) {
+      measurement.pulseWidth = fallingEdgeValue - previousEdgeValue;
+    }
+    lastMeasurement = measurement;
+    push(measurement);
+    if (callback != nullptr) {
+      callback(measurement);
+    }
+  }
+
+  void push(const CaptureMeasurement& measurement) {
+    const uint8_t currentHead = head;
+    if (static_cast<uint8_t>(currentHead - tail) > bufferMask) {
+      numLostMeasurements++;
+      return;
+    }
+    buffer[currentHead & bufferMask] = measurement;
+    head = currentHead + 1;  // Only published after the measurement is written
+  }
+
+  const CallbackFunction callback;
+  const CaptureEdge edge;
+  CaptureMeasurement* const buffer;  ///< Ring buffer of the derived class
+  const uint8_t bufferMask;          ///< Size of the ring buffer - 1
+  volatile uint8_t head = 0;         ///< Free running index of the next entry to write. Written by the interrupt
+  volatile uint8_t tail = 0;         ///< Free running index of the next entry to read. Written by read()
+  uint8_t numEdges = 0;              ///< Number of edges captured since reset, up to 2
+  uint16_t edgeValue = 0;            ///< Counter value of the last edge that starts a period
+  uint16_t fallingEdgeValue = 0;     ///< Counter value of the last falling edge. Only with CaptureEdge::BOTH
+  bool fallingEdgeCaptured = false;  ///< A falling edge was captured after the last rising edge
+  CaptureMeasurement lastMeasurement;
+  volatile uint16_t numLostMeasurements = 0;
+};
+
+/**
+ * Storage of the measurements of a Capture. It is a base class of the Capture, so it is constructed
+ * before the CaptureHandlerBase that keeps a pointer to it.
+ */
+template<uint8_t BUFFER_SIZE>
+class CaptureBuffer {
+protected:
+  std::array<CaptureMeasurement, BUFFER_SIZE> measurements{};
+};
+
+/**
+ * Class to measure an input signal with the capture mode of a Timer_A channel (CCR1 or CCR2).
+ * The timer must run in continuous or tickless mode, so the difference between two captures is valid
+ * up to 0xFFFF counts. E.g. for a signal in P2.1 (TA1.CCI1A):
+ *  @code
+ *    constexpr ContinuousTimerConfig<8, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+ *    Capture<8, 1> knockCapture(&knockDetected, CaptureEdge::BOTH);
+ *
+ *    constexpr InputHandle knockInput = GPIOs::getInputHandle<IOPort::PORT_2, static_cast<uint8_t>(1)>();
+ *    knockInput.init();
+ *    knockInput.setIoFunctionality(IOFunctionality::TA1_CAPTURE_IN1);
+ *    Timer<1>::getTimer().init(TIMER_CONFIG);
+ *    Timer<1>::getTimer().registerCapture<1>(TIMER_CONFIG, knockCapture);
+ *  @endcode
+ *
+ * @tparam CLK_DIV Input divider of the timer clock, as in the timer config.
+ * @tparam SOURCE_CLK_PERIOD_US Period of the source clock in microseconds, as in the timer config.
+ * @tparam BUFFER_SIZE Number of measurements of the ring buffer. Must be a power of two.
+ * @tparam SOURCE_CLK_PERIOD_DEN Denominator of the source clock period, as in the timer config.
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint8_t BUFFER_SIZE = 4, int64_t SOURCE_CLK_PERIOD_DEN = 1>
+class Capture : private CaptureBuffer<BUFFER_SIZE>, public CaptureHandlerBase {
+  static_assert(BUFFER_SIZE > 0 && BUFFER_SIZE <= 128 && (BUFFER_SIZE & (BUFFER_SIZE - 1)) == 0,
+                "The buffer size of the Capture must be a power of two up to 128");
+
+public:
+  using CountPeriod = std::ratio<CLK_DIV * SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>;  ///< One count in us
+  static constexpr uint32_t COUNTS_PER_SECOND = (1000000 * CountPeriod::den) / CountPeriod::num;  ///< Counts in 1s
+
+  /**
+   * Class constructor.
+   * @param callback Function called by the timer interrupt with every measurement. Can be nullptr.
+   * @param edge Edges that are captured
+   */
+  explicit Capture(CallbackFunction callback, CaptureEdge edge = CaptureEdge::RISING)
+    : CaptureHandlerBase(callback, edge, this->measurements.data(), BUFFER_SIZE - 1) {}
+
+  /**
+   * Converts timer counts (period or pulse width) to microseconds. The count period is known
+   * in compile time, so it is a multiplication by a constant (and a shift for the usual power of two clocks).
+   */
+  static constexpr uint32_t toMicroseconds(uint16_t counts) {
+    return (static_cast<uint32_t>(counts) * CountPeriod::num) / CountPeriod::den;
+  }
+
+  /**
+   * Converts a period in timer counts to a frequency in Hz. It needs a division, so it is
+   * intended to be called from the main loop and not from the callback.
+   * @return The frequency. 0 if the period is 0.
+   */
+  static uint32_t toFrequencyHz(uint16_t periodCounts) {
+    return (periodCounts == 0) ? 0 : (COUNTS_PER_SECOND / periodCounts);
+  }
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_CAPTURE_HPP
@@ -0,0 +1,141 @@
+#ifndef MICROTECH_CLOCKSYSTEM_HPP
+#define MICROTECH_CLOCKSYSTEM_HPP
+
+#include "Timer.hpp"
+
+#include <msp430g2553.h>
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+namespace Microtech {
+
+/**
+ * DCO frequencies with factory calibration values in the information memory of the MSP430G2553.
+ */
+enum class DcoFrequency {
+  MHZ_1,
+  MHZ_8,
+  MHZ_12,
+  MHZ_16,  ///< Needs a supply voltage of at least 3.3V
+};
+
+/**
+ * Class to configure the basic clock system. MCLK and SMCLK are sourced by the DCO with the factory
+ * calibration values and ACLK by the internal VLO. The clock periods are exported as compile time
+ * constants, so the timers are configured with the right period math for any frequency. E.g. for 16MHz:
+ *  @code
+ *    using Clocks = ClockSystem<DcoFrequency::MHZ_16>;
+ *
+ *    Clocks::init();
+ *    constexpr Clocks::SmclkTimerConfig<8> TIMER_CONFIG(TimerClockSource::Option::SMCLK);  // 0.5us per count
+ *    Timer<0>::getTimer().init(TIMER_CONFIG);
+ *  @endcode
+ *
+ * @tparam FREQUENCY Frequency of the DCO, which is the frequency of MCLK.
+ * @tparam SMCLK_DIV Divider of SMCLK. Can be 1, 2, 4 or 8.
+ * @tparam ACLK_DIV Divider of ACLK. Can be 1, 2, 4 or 8.
+ */
+template<DcoFrequency FREQUENCY, int64_t SMCLK_DIV = 1, int64_t ACLK_DIV = 1>
+class ClockSystem {
+  static_assert(SMCLK_DIV == 1 || SMCLK_DIV == 2 || SMCLK_DIV == 4 || SMCLK_DIV == 8,
+                "The SMCLK divider can only be 1, 2, 4 or 8");
+  static_assert(ACLK_DIV == 1 || ACLK_DIV == 2 || ACLK_DIV == 4 || ACLK_DIV == 8,
+                "The ACLK divider can only be 1, 2, 4 or 8");
+
+  static constexpr int64_t getDcoFrequencyMHz() {
+    return (FREQUENCY == DcoFrequency::MHZ_1)    ? 1
+           : (FREQUENCY == DcoFrequency::MHZ_8)  ? 8
+           : (FREQUENCY == DcoFrequency::MHZ_12) ? 12
+                                                 : 16;
+  }
+
+  using SmclkPeriod = std::ratio<SMCLK_DIV, getDcoFrequencyMHz()>;                ///< In microseconds
+  using AclkPeriod = std::ratio<1000000 * ACLK_DIV, 12000>;                         ///< In microseconds
+
+public:
+  ClockSystem() = delete;
+
+  static constexpr uint32_t MCLK_FREQUENCY_HZ = getDcoFrequencyMHz() * 1000000;
+  static constexpr uint32_t SMCLK_FREQUENCY_HZ = MCLK_FREQUENCY_HZ / SMCLK_DIV;
+  /// Typical frequency. The VLO is not calibrated and may run from 4kHz to 20kHz (datasheet).
+  static constexpr uint32_t ACLK_FREQUENCY_HZ = 12000 / ACLK_DIV;
+
+  /// The SMCLK period is SMCLK_PERIOD_US / SMCLK_PERIOD_DEN microseconds, e.g. 1 / 16 at 16MHz.
+  static constexpr int64_t SMCLK_PERIOD_US = SmclkPeriod::num;
+  static constexpr int64_t SMCLK_PERIOD_DEN = SmclkPeriod::den;
+  /// The ACLK period is ACLK_PERIOD_US / ACLK_PERIOD_DEN microseconds, e.g. 250 / 3 without divider.
+  static constexpr int64_t ACLK_PERIOD_US = AclkPeriod::num;
+  static constexpr int64_t ACLK_PERIOD_DEN = AclkPeriod::den;
+
+  /**
+   * Timer configurations with the period of SMCLK. The clock source option must still be SMCLK.
+   */
+  template<int64_t CLK_DIV, uint64_t TICK_VALUE = 0, typename TickDuration = std::chrono::microseconds>
+  using SmclkTimerConfig = TimerConfigBase<CLK_DIV, SMCLK_PERIOD_US, TICK_VALUE, TickDuration, SMCLK_PERIOD_DEN>;
+  template<int64_t CLK_DIV>
+  using SmclkContinuousTimerConfig = ContinuousTimerConfig<CLK_DIV, SMCLK_PERIOD_US, SMCLK_PERIOD_DEN>;
+  template<int64_t CLK_DIV>
+  using SmclkTicklessTimerConfig = TicklessTimerConfig<CLK_DIV, SMCLK_PERIOD_US, SMCLK_PERIOD_DEN>;
+
+  /**
+   * Timer configurations with the period of ACLK. The clock source option must still be ACLK.
+   */
+  template<int64_t CLK_DIV, uint64_t TICK_VALUE = 0, typename TickDuration = std::chrono::microseconds>
+  using AclkTimerConfig = TimerConfigBase<CLK_DIV, ACLK_PERIOD_US, TICK_VALUE, TickDuration, ACLK_PERIOD_DEN>;
+  template<int64_t CLK_DIV>
+  using AclkContinuousTimerConfig = ContinuousTimerConfig<CLK_DIV, ACLK_PERIOD_US, ACLK_PERIOD_DEN>;
+  template<int64_t CLK_DIV>
+  using AclkTicklessTimerConfig = TicklessTimerConfig<CLK_DIV, ACLK_PERIOD_US, ACLK_PERIOD_DEN>;
+
+  /**
+   * Configures the clocks. Should be called at the start of main, before the peripherals are initialized.
+   * @return true if the clocks were configured. False if the calibration values were erased, in which
+   *         case the clocks are not changed.
+   */
+  static bool init() noexcept {
+    const uint8_t calibratedBcsctl1 = getCalibratedBcsctl1();
+    if (calibratedBcsctl1 == 0xFF) {
+      return false;  // Erased information memory
+    }
+    DCOCTL = 0;  // Lowest DCO setting first, so the frequency does not overshoot while the range is changed
+    BCSCTL1 = calibratedBcsctl1 | getAclkDividerBits();
+    DCOCTL = getCalibratedDcoctl();
+    BCSCTL2 = SELM_0 | DIVM_0 | getSmclkDividerBits();  // MCLK and SMCLK from the DCO
+    BCSCTL3 = LFXT1S_2;                                 // ACLK from the VLO
+    return true;
+  }
+
+private:
+  static uint8_t getCalibratedBcsctl1() noexcept {
+    switch (FREQUENCY) {
+      case DcoFrequency::MHZ_1: return CALBC1_1MHZ;
+      case DcoFrequency::MHZ_8: return CALBC1_8MHZ;
+      case DcoFrequency::MHZ_12: return CALBC1_12MHZ;
+      case DcoFrequency::MHZ_16: return CALBC1_16MHZ;
+    }
+    return CALBC1_1MHZ;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  static uint8_t getCalibratedDcoctl() noexcept {
+    switch (FREQUENCY) {
+      case DcoFrequency::MHZ_1: return CALDCO_1MHZ;
+      case DcoFrequency::MHZ_8: return CALDCO_8MHZ;
+      case DcoFrequency::MHZ_12: return CALDCO_12MHZ;
+      case DcoFrequency::MHZ_16: return CALDCO_16MHZ;
+    }
+    return CALDCO_1MHZ;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  static constexpr uint8_t getSmclkDividerBits() {
+    return (SMCLK_DIV == 1) ? DIVS_0 : (SMCLK_DIV == 2) ? DIVS_1 : (SMCLK_DIV == 4) ? DIVS_2 : DIVS_3;
+  }
+
+  static constexpr uint8_t getAclkDividerBits() {
+    return (ACLK_DIV == 1) ? DIVA_0 : (ACLK_DIV == 2) ? DIVA_1 : (ACLK_DIV == 4) ? DIVA_2 : DIVA_3;
+  }
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_CLOCKSYSTEM_HPP
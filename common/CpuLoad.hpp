@@ -0,0 +1,135 @@
+#ifndef MICROTECH_CPULOAD_HPP
+#define MICROTECH_CPULOAD_HPP
+
+#include "helpers.hpp"
+
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * CPU load meter based on idle-loop accounting.
+ * The main loop calls idle() on every iteration it has nothing to do, which increments a counter.
+ * A periodic timer task calls windowElapsed() at the end of every measurement window. The fewer
+ * idle iterations in a window, the more time the interrupts took. E.g.:
+ *  @code
+ *    CpuLoad cpuLoad;
+ *
+ *    void cpuLoadWindowTask() {
+ *      cpuLoad.windowElapsed();
+ *    }
+ *
+ *    int main() {
+ *      ...
+ *      TaskHandler<100, std::chrono::milliseconds> cpuLoadTask(&cpuLoadWindowTask, true);
+ *      Timer<0>::getTimer().registerTask(TIMER_CONFIG, cpuLoadTask);
+ *      _enable_interrupt();
+ *      while (true) {
+ *        cpuLoad.idle();
+ *      }
+ *    }
+ *  @endcode
+ *
+ * The number of idle iterations of a window with no load (the reference) is the highest count of all windows.
+ * So one should let a few windows elapse before the other tasks are registered, or set it with setReference().
+ * The idle loop must run less than 65535 iterations in a window, otherwise the count wraps and the load is wrong.
+ * The iterations grow with the CPU clock, so the window must shrink as the clock goes up (e.g. 100ms at 1MHz,
+ * but only about 6ms at 16MHz).
+ *
+ * The interrupt only does a subtraction and a comparison. The percentage is calculated when it is read, after
+ * the counts were copied, so reading the load does not keep the interrupts disabled for the division.
+ */
+class CpuLoad {
+public:
+  static constexpr uint16_t FULL_LOAD = 100 << 8;  ///< 100% in the Q8.8 format returned by getLoad()
+
+  /**
+   * Method to be called by the idle loop. The 16 bits increment is a single instruction,
+   * so it cannot be torn by the interrupt that reads the counter.
+   */
+  inline void idle() noexcept {
+    idleCounter++;
+  }
+
+  /**
+   * Method to be called by a periodic timer task at the end of every measurement window.
+   */
+  inline void windowElapsed() noexcept {
+    const uint16_t counter = idleCounter;
+    const uint16_t windowIdleCount = counter - windowStartCounter;  // Free running counter, the wrap is handled
+    windowStartCounter = counter;
+    lastIdleCount = windowIdleCount;
+    if (windowIdleCount > referenceIdleCount) {
+      referenceIdleCount = windowIdleCount;
+    }
+    if (windowIdleCount < minIdleCount) {
+      minIdleCount = windowIdleCount;
+    }
+  }
+
+  /**
+   * Sets the number of idle iterations of a window without load. E.g. measured once with
+   * getReference() in a build without the other tasks.
+   */
+  void setReference(uint16_t idleCountPerWindow) noexcept {
+    CriticalSection criticalSection;
+    referenceIdleCount = idleCountPerWindow;
+  }
+
+  uint16_t getReference() const noexcept {
+    CriticalSection criticalSection;
+    return referenceIdleCount;
+  }
+
+  /**
+   * @return The CPU load of the last window in Q8.8 fixed point percentage. E.g. 0x1980 is 25.5%.
+   */
+  uint16_t getLoad() const noexcept {
+    uint16_t idleCount;
+    uint16_t reference;
+    {
+      CriticalSection criticalSection;  // Both counts must come from the same window
+      idleCount = lastIdleCount;
+      reference = referenceIdleCount;
+    }
+    return calculateLoad(idleCount, reference);
+  }
+
+  /**
+   * @return The highest CPU load of all windows since the last resetPeakLoad() in Q8.8 fixed point percentage.
+   */
+  uint16_t getPeakLoad() const noexcept {
+    uint16_t idleCount;
+    uint16_t reference;
+    {
+      CriticalSection criticalSection;  // Both counts must come from the same window
+      idleCount = minIdleCount;
+      reference = referenceIdleCount;
+    }
+    return calculateLoad(idleCount, reference);
+  }
+
+  void resetPeakLoad() noexcept {
+    CriticalSection criticalSection;
+    minIdleCount = UINT16_MAX;
+  }
+
+private:
+  static uint16_t calculateLoad(uint16_t idleCount, uint16_t reference) noexcept {
+    if (reference == 0 || idleCount > reference) {
+      return 0;  // No window measured yet
+    }
+    const uint32_t idleShare = (static_cast<uint32_t>(idleCount) * FULL_LOAD) / reference;
+    return static_cast<uint16_t>(FULL_LOAD - idleShare);
+  }
+
+  volatile uint16_t idleCounter = 0;      ///< Free running counter of idle iterations. Written by the main loop
+  uint16_t windowStartCounter = 0;        ///< Idle counter at the start of the window. Written by the timer task
+  uint16_t lastIdleCount = 0;             ///< Idle iterations of the last window
+  uint16_t referenceIdleCount = 0;        ///< Idle iterations of a window without load
+  uint16_t minIdleCount = UINT16_MAX;     ///< Fewest idle iterations of a window, used for the peak load
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_CPULOAD_HPP
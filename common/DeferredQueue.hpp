@@ -0,0 +1,111 @@
+#ifndef MICROTECH_DEFERREDQUEUE_HPP
+#define MICROTECH_DEFERREDQUEUE_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Queue of deferred calls. It allows interrupts to hand slow work (serial prints, bit-banged
+ * shift register reads...) over to the main loop, so the interrupts stay short and the latency
+ * of the other interrupts stays bounded. E.g.:
+ *  @code
+ *    DeferredQueue<8> deferredQueue;
+ *
+ *    void timerTask() {                     // Called in the timer interrupt
+ *      deferredQueue.post(&printValues);    // printValues is executed later by the main loop
+ *    }
+ *
+ *    int main() {
+ *      ...
+ *      while (true) {
+ *        deferredQueue.runAll();
+ *      }
+ *    }
+ *  @endcode
+ *
+ * It is a single-producer/single-consumer ring buffer. The producer are the interrupts (they don't nest in
+ * the MSP430 unless one enables it explicitly) and the consumer is the main loop. Each side only writes its
+ * own index, so no interrupt has to be disabled to post or run a call.
+ *
+ * @tparam CAPACITY Number of calls the queue can hold. Must be a power of two, so the indexes wrap with a mask.
+ */
+template<uint8_t CAPACITY>
+class DeferredQueue {
+  static_assert(CAPACITY > 0 && CAPACITY <= 128 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "The capacity of the DeferredQueue must be a power of two up to 128");
+
+public:
+  typedef void (*Callback)();  ///< Type definition of a deferred call
+
+  /**
+   * Method to post a call to the queue. Intended to be called from an interrupt.
+   * @param callback Function to be called by the main loop
+   * @return true if the call was queued. False if the callback is null or the queue is full.
+   *         In this case the call is dropped and counted in getNumDroppedCalls().
+   */
+  bool post(Callback callback) noexcept {
+    if (callback == nullptr) {
+      return false;
+    }
+    const uint8_t currentHead = head;
+    if (static_cast<uint8_t>(currentHead - tail) >= CAPACITY) {
+      numDroppedCalls++;
+      return false;
+    }
+    calls[currentHead & INDEX_MASK] = callback;
+    head = currentHead + 1;  // Only published after the call is written
+    return true;
+  }
+
+  /**
+   * Method to execute the oldest call of the queue. Intended to be called from the main loop.
+   * @return true if a call was executed. False if the queue was empty.
+   */
+  bool runNext() {
+    const uint8_t currentTail = tail;
+    if (currentTail == head) {
+      return false;
+    }
+    const Callback callback = calls[currentTail & INDEX_MASK];
+    tail = currentTail + 1;  // Frees the entry before the call, so the call itself can post again
+    callback();
+    return true;
+  }
+
+  /**
+   * Method to execute all the calls in the queue, including the ones posted while it is running.
+   * Intended to be called from the main loop.
+   */
+  void runAll() {
+    while (runNext()) {
+    }
+  }
+
+  /**
+   * @return true if there is no call waiting in the queue.
+   */
+  bool isEmpty() const noexcept {
+    return head == tail;
+  }
+
+  /**
+   * @return Number of calls dropped because the queue was full.
+   */
+  uint16_t getNumDroppedCalls() const noexcept {
+    return numDroppedCalls;
+  }
+
+private:
+  static constexpr uint8_t INDEX_MASK = CAPACITY - 1;
+
+  std::array<Callback, CAPACITY> calls{};  ///< Ring buffer with the calls
+  volatile uint8_t head = 0;               ///< Free running index of the next entry to write. Written by the producer
+  volatile uint8_t tail = 0;               ///< Free running index of the next entry to read. Written by the consumer
+  volatile uint16_t numDroppedCalls = 0;   ///< Number of calls dropped because the queue was full
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_DEFERREDQUEUE_HPP
@@ -55,6 +55,9 @@ enum class IOFunctionality {
   GPIO = 0,
   TA0_COMPARE_OUT1,
   TA0_COMPARE_OUT2,
+  TA0_CAPTURE_IN1,  ///< P1.2 as TA0.CCI1A
+  TA1_CAPTURE_IN1,  ///< P2.1 as TA1.CCI1A
+  TA1_CAPTURE_IN2,  ///< P2.4 as TA1.CCI2A
 };
 
 /**
@@ -245,7 +248,8 @@ protected:
  *
  */
 class IoHandleBase {
-  friend class Pwm;
+  template<typename>
+  friend class BasicPwm;
 
 public:
   IoHandleBase() = delete;
@@ -324,6 +328,27 @@ public:
           return true;
         }
         return false;
+      case IOFunctionality::TA0_CAPTURE_IN1:
+        if (port == IOPort::PORT_1 && mPin == 2) {
+          setRegisterBits(PxSel, mBitMask);
+          resetRegisterBits(PxSel2, mBitMask);
+          return true;
+        }
+        return false;
+      case IOFunctionality::TA1_CAPTURE_IN1:
+        if (port == IOPort::PORT_2 && mPin == 1) {
+          setRegisterBits(PxSel, mBitMask);
+          resetRegisterBits(PxSel2, mBitMask);
+          return true;
+        }
+        return false;
+      case IOFunctionality::TA1_CAPTURE_IN2:
+        if (port == IOPort::PORT_2 && mPin == 4) {
+          setRegisterBits(PxSel, mBitMask);
+          resetRegisterBits(PxSel2, mBitMask);
+          return true;
+        }
+        return false;
     };
 
     return false;
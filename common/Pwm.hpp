@@ -20,48 +20,73 @@
 #include "IQmathLib.h"
 #include <msp430g2553.h>
 #include <chrono>
-#include <memory>
+#include <cstdint>
 
 namespace Microtech {
 /**
- * Class to abstract the PWM.
+ * Class to abstract the PWM. It uses the timer 0, so it cannot be used while the timer 0 triggers the
+ * conversions of the ADC (see Adc::setTimerTrigger()). Then the methods do nothing and return false.
+ * @tparam TimerConfig Configuration of the timer in up mode with the SMCLK period,
+ *                     e.g. ClockSystem<DcoFrequency::MHZ_16>::SmclkTimerConfig<8>.
  */
-class Pwm {
+template<typename TimerConfig = TimerConfigBase<8, 1>>
+class BasicPwm {
 public:
-  Pwm() = delete;
-  explicit Pwm(const OutputHandle& outputPin) : pwmOutput(outputPin), TIMER_CONFIG(TimerClockSource::Option::SMCLK){}
+  BasicPwm() = delete;
+  explicit BasicPwm(const OutputHandle& outputPin)
+    : pwmOutput(outputPin), TIMER_CONFIG(TimerClockSource::Option::SMCLK) {}
 
-  void init() const {
+  /**
+   * Method to initialize the timer 0 and the pin of the PWM.
+   * @return true if the PWM was initialized. False if the timer 0 is used by the ADC.
+   */
+  bool init() const {
+    if (isTimerUsedByAdc()) {
+      return false;
+    }
     Timer<0>::getTimer().init(TIMER_CONFIG);
     pwmOutput.init();
     pwmOutput.disablePinResistor();
     pwmOutput.setIoFunctionality(IOFunctionality::TA0_COMPARE_OUT2);
     TA0CCTL2 = OUTMOD_3;
+    return true;
   }
 
   /**
-   * Class to set the period of the PWM
+   * Method to set the period of the PWM in runtime.
    * At the moment we are using the timer 0 as the timer for the PWM.
-   * So this method basically registers a task in the timer, and
-   * since the init configured TA0CTTL2, the compar value of the timer will
-   * be in the pwmOutput.
+   * So this method sets the period of the timer and, since the init configured TA0CTTL2,
+   * the compare value of the timer will be in the pwmOutput. The CCR0 interrupt is not used.
+   * @param periodUs Period in microseconds. 0 stops the PWM (e.g. a pause between notes).
+   * @return true if the period was set. False if it is out of the timer range or the timer is used by the ADC.
    */
-  template<uint64_t periodValue, typename Duration = std::chrono::microseconds>
-  void setPwmPeriod() {
-    // Pointer of a newTask
-    std::unique_ptr<TaskHandler<periodValue, Duration>> newTask =
-      std::make_unique<TaskHandler<periodValue, Duration>>(nullptr, true);
-
-    if (currentTask) {  // if there is a task playing, deregister the task
-      Timer<0>::getTimer().deregisterTask(*currentTask);
+  bool setPeriod(uint32_t periodUs) {
+    if (isTimerUsedByAdc()) {
+      return false;
+    }
+    if (periodUs == 0) {
+      stop();
+      return true;
+    }
+    if (!Timer<0>::getTimer().setPeriod(TIMER_CONFIG, periodUs)) {
+      return false;
     }
-    // Register the newTask
-    Timer<0>::getTimer().registerTask(TIMER_CONFIG, *newTask);
-
     // Update dutycycle, since comparator value changed.
     updateDutyCycleRegister();
+    return true;
+  }
 
-    currentTask = std::move(newTask);  // Stores new task pointer.
+  /**
+   * Method to set the period of the PWM when it is known in compile time.
+   * The period is converted to microseconds in compile time and set with setPeriod(),
+   * so each period only adds a call with a constant to the binary.
+   */
+  template<uint64_t periodValue, typename Duration = std::chrono::microseconds>
+  void setPwmPeriod() {
+    constexpr uint64_t PERIOD_US =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Duration(periodValue)).count());
+    static_assert(PERIOD_US <= 0xFFFFFFFF, "Cannot set desired PWM period. It exceeds the timer range");
+    setPeriod(static_cast<uint32_t>(PERIOD_US));
   }
 
   /**
@@ -69,38 +94,49 @@ public:
    * The duty cycle can be between 0 and 100.
    */
   bool setDutyCycle(const _iq15 newDutyCycle) {
-    if (newDutyCycle > MAX_DUTY_CYCLE) {
+    if (newDutyCycle > MAX_DUTY_CYCLE || isTimerUsedByAdc()) {
       return false;
     }
-    dutyCycle = newDutyCycle;
+    // The division is done here, so a period change only needs a multiplication.
+    dutyCycleFraction = _IQ15div(newDutyCycle, MAX_DUTY_CYCLE);
     updateDutyCycleRegister();
     return true;
   }
 
   void stop() {
-    Timer<0>::getTimer().stop();
+    if (!isTimerUsedByAdc()) {
+      Timer<0>::getTimer().stop();
+    }
   }
 
 private:
+  /**
+   * @return true if the timer 0 triggers the conversions of the ADC. Then it belongs to the ADC.
+   */
+  static bool isTimerUsedByAdc() noexcept {
+    return (ADC10CTL1 & SHS_3) != 0;
+  }
+
   /**
    * Method to configure the register responsible by the duty cycle.
    */
   void updateDutyCycleRegister() {
     const _iq15 valueCCR0 = _IQ15(TACCR0);  // Reads current "period" register
     //  Calculates the value of the CCR2 based on the value of the current CCR0 value.
-    const _iq15 valueCCR1 = _IQ15div(_IQ15mpy(valueCCR0, dutyCycle), MAX_DUTY_CYCLE);
-    TA0CCR2 = _IQ15int(valueCCR1);
+    const _iq15 valueCCR2 = _IQ15mpy(valueCCR0, dutyCycleFraction);
+    TA0CCR2 = _IQ15int(valueCCR2);
   }
 
   static constexpr _iq15 MAX_DUTY_CYCLE = _IQ15(100.0);
 
   const OutputHandle pwmOutput;
 
-  const TimerConfigBase<8, 1> TIMER_CONFIG;
-  std::unique_ptr<TaskHandlerBase> currentTask;
-  _iq15 dutyCycle = 0;
+  const TimerConfig TIMER_CONFIG;
+  _iq15 dutyCycleFraction = 0;  ///< Duty cycle between 0 and 1
 };
 
+using Pwm = BasicPwm<>;  ///< PWM with SMCLK at 1MHz
+
 }  // namespace Microtech
 
 #endif  // MICROTECH_PWM_HPP
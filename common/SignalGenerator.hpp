@@ -3,18 +3,22 @@
 
 #include <cstdint>
 #include "IQmathLib.h"
+#include "Wavetable.hpp"
+#include "helpers.hpp"
 
 namespace Microtech {
 
-#define PI 3.1415926536
-
 /**
  * @class SignalProperties
  * @brief Class for storing properties of the signal
+ *
+ * The phase is a direct digital synthesis (DDS) phase accumulator: a full period is 2^32, so the phase wraps
+ * naturally when it overflows and each sample costs a single addition. The phase step (tuning word) is
+ * frequency * 2^32 / fs and is only calculated when the frequency changes.
  */
 class SignalProperties {
 public:
-  using PhaseType = _iq15;
+  using PhaseType = uint32_t;  ///< Phase where 2^32 is a full period
   /**
    * @brief deleted default constructor
    */
@@ -34,23 +38,39 @@ public:
    * @param[in] newFrequency new frequency of the signal
    */
   void setNewFrequency(const _iq15 newFrequency) {
+    setNewFrequency(newFrequency, calculatePhaseStep(newFrequency));
+  }
+
+  /**
+   * @brief set the new frequency of the signal with a phase step calculated by calculatePhaseStep()
+   * @param[in] newFrequency new frequency of the signal
+   * @param[in] newPhaseStep phase step of the new frequency
+   */
+  void setNewFrequency(const _iq15 newFrequency, const PhaseType newPhaseStep) noexcept {
     currentFrequency = newFrequency;
-    // 2*pi*currentFrequency/samplingFreqHz
-    const _iq15 freqInCyclesPerSecond = _IQ15mpy(_IQ15(2 * PI), currentFrequency);
-    phaseStep = _IQ15div(freqInCyclesPerSecond, _IQ15(samplingFreqHz));
+    phaseStep = newPhaseStep;
+  }
+
+  /**
+   * @brief calculate the phase step of a frequency. The signal is not changed.
+   * @param[in] frequency frequency of the signal
+   * @return phase step of the frequency
+   */
+  PhaseType calculatePhaseStep(const _iq15 frequency) const {
+    // frequency * 2^32 / samplingFreqHz. The frequency has 15 fractional bits, so it is shifted by 17.
+    return static_cast<PhaseType>((static_cast<uint64_t>(toQ15Bits(frequency)) << 17) / samplingFreqHz);
   }
 
   /**
    * @brief increase the phase of the signal
    */
   void increasePhase() noexcept {
-    // calculate new phase and keep it within 0 and 2pi.
-    currentPhase = std::fmod((currentPhase + phaseStep), _IQ15(2 * PI));
+    currentPhase += phaseStep;  // Wraps at 2^32, which is exactly one period
   }
 
   /**
    * @brief get the current phase of the signal
-   * @return current phase of the signal
+   * @return current phase of the signal, where 2^32 is a full period
    */
   PhaseType getCurrentPhase() const noexcept {
     return currentPhase;
@@ -61,6 +81,17 @@ public:
   }
 
 private:
+  /**
+   * @brief get the bits of a positive value in Q15, with the same result with and without the IQmath library
+   * @param[in] value value to be converted
+   * @return value * 2^15
+   */
+  static uint32_t toQ15Bits(const _iq15 value) noexcept {
+    const int32_t integerPart = _IQ15int(value);
+    const _iq15 fractionalPart = value - _IQ15(integerPart);
+    return (static_cast<uint32_t>(integerPart) << 15) + _IQ15int(_IQ15mpy(fractionalPart, _IQ15(32768.0)));
+  }
+
   const uint16_t samplingFreqHz;  ///< Sampling frequency of the signal
   _iq15 currentFrequency = 0;     ///< Current frequency of the signal
   PhaseType phaseStep = 0;        ///< Current phase step of the signal
@@ -96,159 +127,61 @@ protected:
 };
 
 /**
- * @brief Class representing a Sinusoidal signal
+ * @brief Class representing a signal read from a wavetable
+ *
+ * The shape is calculated in compile time and stored in flash, so each point costs one table read,
+ * plus a multiplication with the interpolation, and the scaling to the amplitude.
+ * @tparam SHAPE Shape of the signal
+ * @tparam SIZE_BITS Number of points of the table as a power of two
+ * @tparam MAX_VALUE Value at the top of the table. It must be a power of two, so that the amplitude of a value
+ *                   is exact in Q15 and the top of the table is exactly the maximum amplitude.
+ * @tparam INTERPOLATION If true the points are interpolated linearly between the entries of the table
  */
-class Sinusoidal : public iSignalType {
-public:
-  /**
-   * @brief default constructor
-   */
-  Sinusoidal() = default;
-
-  /**
-   * @brief get the next point of the Sinusoidal signal
-   * @param[in] signal Signal properties
-   * @return next point of the Sinusoidal signal
-   */
-  _iq15 getNextPoint(SignalProperties& signal) noexcept override {
-    // sin gives value from -1 to 1, so we add 1 to get the output from 0 to 2
-    const _iq15 sineValue = _IQ15sin(signal.getCurrentPhase()) + _IQ15(1);
-    const _iq15 HALF_OF_MAX_AMPLITUDE = _IQ15div(MAXIMUM_AMPLITUDE, _IQ15(2.0));
-
-    // Multiply by 50.0 since our maximum value is 100.0 and the maximum from the sine is 2.
-    const _iq15 sineScaled = _IQ15mpy(sineValue, HALF_OF_MAX_AMPLITUDE);
-    return sineScaled;
-  }
-};
+template<WaveShape SHAPE, uint8_t SIZE_BITS, uint16_t MAX_VALUE, bool INTERPOLATION>
+class WavetableSignal : public iSignalType {
+  static_assert((MAX_VALUE & (MAX_VALUE - 1)) == 0, "The top of the wavetable must be a power of two");
 
-/**
- * @brief Class representing Trapezoidal signal
- */
-class Trapezoidal : public iSignalType {
 public:
   /**
    * @brief default constructor
    */
-  Trapezoidal() = default;
+  WavetableSignal() = default;
 
   /**
-   * @brief get the next point of the Trapezoidal signal
+   * @brief get the next point of the signal
    * @param[in] signal Signal properties
-   * @return next point of the Trapezoidal signal
+   * @return next point of the signal
    */
   _iq15 getNextPoint(SignalProperties& signal) noexcept override {
-    const _iq15 currentPhase = signal.getCurrentPhase();
-    const _iq15 slope = getSlope();
-    const _iq15 yIntercept = getYIntercept();
-
-    // Use a switch case to check for the current phase
-    switch (getCurrentPhase(currentPhase)) {
-      case Phase::PHASE_1: return _IQ15mpy(slope, currentPhase) + yIntercept;
-      case Phase::PHASE_2: return MAXIMUM_AMPLITUDE;
-      case Phase::PHASE_3:
-        // The last constant value has to be added to compensate since the angle is higher
-        return _IQ15mpy(_IQ15(-1),_IQ15mpy(currentPhase,slope)) + yIntercept + _IQ15(300.0);
-      case Phase::PHASE_4: return _IQ15(0.0);
-      case Phase::PHASE_5: return _IQ15mpy(slope, currentPhase) + yIntercept - _IQ15(600.0);
-      default: return _IQ15(0.0);
-    }
+    const uint16_t value = INTERPOLATION ? Table::interpolate(signal.getCurrentPhase())
+                                         : Table::lookup(signal.getCurrentPhase());
+    return _IQ15mpyI32(AMPLITUDE_PER_VALUE, static_cast<int32_t>(value));
   }
 
 private:
-  /**
-   * @brief Get the slope of the Trapezoidal signal
-   * @return The slope of the Trapezoidal signal
-   */
-  _iq15 getSlope() const noexcept {
-    return _IQ15div(MAXIMUM_AMPLITUDE, DEG60_IN_RAD);
-  }
-
-  /**
-   * @brief Get the y-intercept of the Trapezoidal signal
-   * @return The y-intercept of the Trapezoidal signal
-   */
-  constexpr _iq15 getYIntercept() const noexcept {
-    return _IQ15(50.0);
-  }
-
-  // define a struct to store the phase intervals
-  struct IntervalPhases {
-    _iq15 start;
-    _iq15 end;
-  };
-
-  enum class Phase {
-      PHASE_1,
-      PHASE_2,
-      PHASE_3,
-      PHASE_4,
-      PHASE_5
-  };
-  const IntervalPhases PHASE_1 = {DEG0_IN_RAD, DEG30_IN_RAD};
-  const IntervalPhases PHASE_2 = {DEG30_IN_RAD, DEG150_IN_RAD};
-  const IntervalPhases PHASE_3 = {DEG150_IN_RAD, DEG210_IN_RAD};
-  const IntervalPhases PHASE_4 = {DEG210_IN_RAD, DEG330_IN_RAD};
-  const IntervalPhases PHASE_5 = {DEG330_IN_RAD, DEG360_IN_RAD};
-
-  /**
-   * @brief Get the current phase of the signal
-   * @param[in] currentPhase The current phase of the signal
-   * @return The current phase of the signal
-   */
-  Phase getCurrentPhase(const _iq15 currentPhase) const {
-    if (currentPhase >= PHASE_1.start && currentPhase < PHASE_1.end) {
-      return Phase::PHASE_1;
-    } else if (currentPhase >= PHASE_2.start && currentPhase < PHASE_2.end) {
-      return Phase::PHASE_2;
-    } else if (currentPhase >= PHASE_3.start && currentPhase < PHASE_3.end) {
-      return Phase::PHASE_3;
-    } else if (currentPhase >= PHASE_4.start && currentPhase < PHASE_4.end) {
-      return Phase::PHASE_4;
-    } else if (currentPhase >= PHASE_5.start && currentPhase < PHASE_5.end) {
-      return Phase::PHASE_5;
-    } else {
-      return Phase::PHASE_1;
-    }
-  }
-
-  static constexpr _iq15 DEG0_IN_RAD = _IQ15(0);
-  static constexpr _iq15 DEG30_IN_RAD = _IQ15(PI / 6);
-  static constexpr _iq15 DEG60_IN_RAD = _IQ15(PI / 3);
-  static constexpr _iq15 DEG120_IN_RAD = _IQ15(2 * PI / 3);
-  static constexpr _iq15 DEG150_IN_RAD = DEG30_IN_RAD + DEG120_IN_RAD;
-  static constexpr _iq15 DEG210_IN_RAD = DEG150_IN_RAD + DEG60_IN_RAD;
-  static constexpr _iq15 DEG330_IN_RAD = DEG210_IN_RAD + DEG120_IN_RAD;
-  static constexpr _iq15 DEG360_IN_RAD = _IQ15(2 * PI);
+  using Table = Wavetable<SHAPE, SIZE_BITS, MAX_VALUE>;
+  static constexpr _iq15 AMPLITUDE_PER_VALUE = MAXIMUM_AMPLITUDE / MAX_VALUE;
 };
 
 /**
- * @brief Class representing Rectangular signal
+ * @brief Sinusoidal signal: 256 points from 0 to 4096 with interpolation (514 bytes of flash)
  */
-class Rectangular : public iSignalType {
-public:
-  /**
-   * @brief default constructor
-   */
-  Rectangular() = default;
+using Sinusoidal = WavetableSignal<WaveShape::SINE, 8, 4096, true>;
 
-  /**
-   * @brief get the next point of the Rectangular signal
-   * @param[in] signal Signal properties
-   * @return next point of the Rectangular signal
-   */
-  _iq15 getNextPoint(SignalProperties& signal) noexcept override {
-    _iq15 retVal = 0;
-    if (signal.getCurrentPhase() < _IQ15(PI)) {
-      retVal = MAXIMUM_AMPLITUDE;
-    } else {
-      retVal = _IQ15(0);
-    }
-    return retVal;
-  }
-};
+/**
+ * @brief Trapezoidal signal: 256 points from 0 to 4096 with interpolation (514 bytes of flash).
+ * The corners are not exactly on the points of the table, so they are slightly rounded.
+ */
+using Trapezoidal = WavetableSignal<WaveShape::TRAPEZOID, 8, 4096, true>;
+
+/**
+ * @brief Rectangular signal: 2 points of 0 or 1. Interpolating would turn the edges into ramps.
+ */
+using Rectangular = WavetableSignal<WaveShape::RECTANGLE, 1, 1, false>;
 
 /**
  * @brief Generates different types of signals (sinusoidal, trapezoidal, and rectangular) and switch between them.
+ * The frequency and the shape can be changed by the main loop while an interrupt calls getNextDatapoint().
  */
 class SignalGenerator {
 public:
@@ -281,10 +214,14 @@ public:
 
   /**
    * @brief set a new frequency for the signal
+   * The phase step has 32 bits, so it is written in two halves. It is calculated before the interrupts
+   * are disabled, so they are only disabled while it is written.
    * @param[in] newFrequency new frequency
    */
   void setNewFrequency(const _iq15 newFrequency) noexcept {
-    signalProperties.setNewFrequency(newFrequency);
+    const SignalProperties::PhaseType newPhaseStep = signalProperties.calculatePhaseStep(newFrequency);
+    CriticalSection criticalSection;
+    signalProperties.setNewFrequency(newFrequency, newPhaseStep);
   }
 
   /**
@@ -326,7 +263,7 @@ public:
   void increaseFrequency() {
     const _iq15 currentFrequency = signalProperties.getCurrentFrequency();
     if (currentFrequency < MAXIMUM_FREQUENCY) {
-      signalProperties.setNewFrequency(currentFrequency + FREQUENCY_STEP);
+      setNewFrequency(currentFrequency + FREQUENCY_STEP);
     }
   }
   /**
@@ -336,7 +273,7 @@ public:
   void decreaseFrequency() {
     const _iq15 currentFrequency = signalProperties.getCurrentFrequency();
     if (currentFrequency > MINIMUM_FREQUENCY) {
-      signalProperties.setNewFrequency(currentFrequency - FREQUENCY_STEP);
+      setNewFrequency(currentFrequency - FREQUENCY_STEP);
     }
   }
 
@@ -0,0 +1,195 @@
+#ifndef MICROTECH_STATICSCHEDULER_HPP
+#define MICROTECH_STATICSCHEDULER_HPP
+
+#include "Timer.hpp"
+#include "helpers.hpp"
+
+#include <msp430g2553.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+namespace Microtech {
+
+/**
+ * Task of a StaticScheduler. Differently from the TaskHandler, the callback is a template parameter,
+ * so the compiler knows in compile time which function is called and can call it directly (or even inline it).
+ * There is no function pointer stored in RAM and no null check in the interrupt.
+ *
+ * @tparam CALLBACK Function called when the task is due
+ * @tparam periodValue Period of the task
+ * @tparam Duration Time scale of the period (milliseconds, microseconds...)
+ */
+template<void (*CALLBACK)(), uint64_t periodValue, typename Duration = std::chrono::microseconds>
+class StaticTask {
+public:
+  static_assert(CALLBACK != nullptr, "The callback of a StaticTask cannot be null");
+
+  /// Period of the task in microseconds. Evaluated in compile time.
+  static constexpr uint64_t PERIOD_US =
+    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Duration(periodValue)).count());
+  static_assert(PERIOD_US > 0, "The period of a StaticTask cannot be 0");
+
+  /**
+   * Calls the task callback.
+   */
+  static inline void call() {
+    CALLBACK();
+  }
+};
+
+/**
+ * Scheduler where the whole task table is resolved in compile time.
+ * The base tick, the tick divisor of each task and the callbacks are all template parameters,
+ * so the timer interrupt is expanded to a straight-line sequence of countdowns and direct calls.
+ * The only RAM used is one 16 bits countdown per task.
+ *
+ * If the config has a base tick (TICK_VALUE), it is used. Otherwise the base tick is the greatest
+ * common divisor of all task periods, which is the longest tick that still serves all tasks exactly.
+ *
+ * Since the scheduler owns the CCR0 interrupt of the timer, one has to define
+ * MICROTECH_CUSTOM_TIMERx_A0_ISR before including Timer.hpp and forward the interrupt to the scheduler:
+ *  @code
+ *    #define MICROTECH_CUSTOM_TIMER1_A0_ISR
+ *    #include "StaticScheduler.hpp"
+ *
+ *    using Scheduler = StaticScheduler<1, TimerConfigBase<8, 1>,
+ *                                      StaticTask<&samplingTask, 20, std::chrono::milliseconds>,
+ *                                      StaticTask<&displayTask, 2, std::chrono::seconds>>;
+ *    int main() {
+ *      Scheduler::start(TimerClockSource::Option::SMCLK);
+ *      ...
+ *    }
+ *
+ *    #pragma vector = TIMER1_A0_VECTOR
+ *    __interrupt void Timer1_A_CCR0_ISR(void) {
+ *      Scheduler::interruptionHappened();
+ *    }
+ *  @endcode
+ *
+ * @tparam TIMER_NUMBER The number of the timer.
+ * @tparam TimerConfig A TimerConfigBase type with the clock divider and source clock period.
+ * @tparam Tasks StaticTask types.
+ */
+template<uint8_t TIMER_NUMBER, typename TimerConfig, typename... Tasks>
+class StaticScheduler;
+
+template<uint8_t TIMER_NUMBER, int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE,
+         typename TickDuration, int64_t SOURCE_CLK_PERIOD_DEN, typename... Tasks>
+class StaticScheduler<TIMER_NUMBER, TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_VALUE, TickDuration,
+                                                      SOURCE_CLK_PERIOD_DEN>,
+                      Tasks...> {
+  static_assert(sizeof...(Tasks) > 0, "The StaticScheduler needs at least one task");
+  using TimerType = Timer<TIMER_NUMBER>;
+
+  /**
+   * Greatest common divisor of the values. Evaluated in compile time.
+   */
+  static constexpr uint64_t greatestCommonDivisor(uint64_t value) {
+    return value;
+  }
+
+  template<typename... Values>
+  static constexpr uint64_t greatestCommonDivisor(uint64_t value, uint64_t otherValue, Values... values) {
+    return greatestCommonDivisor((otherValue == 0) ? value : greatestCommonDivisor(otherValue, value % otherValue),
+                                 values...);
+  }
+
+public:
+  StaticScheduler() = delete;
+
+  /// Base tick of the scheduler in microseconds. Evaluated in compile time.
+  static constexpr uint64_t TICK_US =
+    (TICK_VALUE == 0)
+      ? greatestCommonDivisor(Tasks::PERIOD_US...)
+      : static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(TickDuration(TICK_VALUE)).count());
+
+  /**
+   * Configures the timer in up mode with the base tick and starts it.
+   * One must call _enable_interrupt() at some other time for the interruption to start to happen.
+   * @param clkSource Clock source of the timer
+   */
+  static void start(TimerClockSource::Option clkSource) {
+    constexpr uint16_t TIMER_INPUT_DIVIDER = TimerType::template getTimerInputDivider<CLK_DIV>();
+    constexpr uint16_t COMPARE_VALUE =
+      TimerType::template calculateCompareValue<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_US, std::chrono::microseconds,
+                                                SOURCE_CLK_PERIOD_DEN>();
+
+    TimerType::getTAxCTL() = TimerClockSource::getTASSELValue(clkSource) + TIMER_INPUT_DIVIDER + MC_0 + TACLR;
+    resetCountdowns(std::index_sequence_for<Tasks...>{});
+    TimerType::getTAxCCR0() = COMPARE_VALUE;
+    TimerType::getTAxCCTL0() = CCIE;
+    setRegisterBits(TimerType::getTAxCTL(), static_cast<uint16_t>(MC_1));
+  }
+
+  /**
+   * Stops the timer and its interrupt.
+   */
+  static void stop() {
+    resetRegisterBits(TimerType::getTAxCTL(), static_cast<uint16_t>(MC_3));
+    resetRegisterBits(TimerType::getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+  }
+
+  /**
+   * Function must be called by the CCR0 timer interrupt.
+   * It is expanded in compile time to one countdown and call per task.
+   */
+  static inline void interruptionHappened() {
+    dispatch(std::index_sequence_for<Tasks...>{});
+  }
+
+private:
+  /**
+   * Number of base ticks between two calls of a task. Evaluated in compile time.
+   */
+  template<typename Task>
+  static constexpr uint16_t getTickDivisor() {
+    static_assert(Task::PERIOD_US % TICK_US == 0, "Task period must be a multiple of the scheduler base tick");
+    static_assert(Task::PERIOD_US / TICK_US <= 0xFFFF, "Task period is too long for the scheduler base tick");
+    return static_cast<uint16_t>(Task::PERIOD_US / TICK_US);
+  }
+
+  template<std::size_t... INDEXES>
+  static void resetCountdowns(std::index_sequence<INDEXES...>) {
+    using Expander = int[];
+    (void)Expander{0, (ticksUntilDue[INDEXES] = getTickDivisor<Tasks>(), 0)...};
+  }
+
+  template<std::size_t... INDEXES>
+  static inline void dispatch(std::index_sequence<INDEXES...>) {
+    using Expander = int[];
+    (void)Expander{0, (tickTask<INDEXES, Tasks>(), 0)...};
+  }
+
+  /**
+   * Counts down one tick of the task and calls it when it is due.
+   * Tasks with the same period as the base tick are called directly, the compiler removes the countdown.
+   */
+  template<std::size_t INDEX, typename Task>
+  static inline void tickTask() {
+    constexpr uint16_t TICK_DIVISOR = getTickDivisor<Task>();
+    if (TICK_DIVISOR == 1) {
+      Task::call();
+      return;
+    }
+    if (--ticksUntilDue[INDEX] == 0) {
+      ticksUntilDue[INDEX] = TICK_DIVISOR;
+      Task::call();
+    }
+  }
+
+  static std::array<uint16_t, sizeof...(Tasks)> ticksUntilDue;  ///< Countdown of base ticks of each task
+};
+
+template<uint8_t TIMER_NUMBER, int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE,
+         typename TickDuration, int64_t SOURCE_CLK_PERIOD_DEN, typename... Tasks>
+std::array<uint16_t, sizeof...(Tasks)>
+  StaticScheduler<TIMER_NUMBER,
+                  TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_VALUE, TickDuration, SOURCE_CLK_PERIOD_DEN>,
+                  Tasks...>::ticksUntilDue{};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_STATICSCHEDULER_HPP
@@ -21,15 +21,23 @@
 #ifndef COMMON_TIMER_HPP_
 #define COMMON_TIMER_HPP_
 
+#include "Capture.hpp"
 #include "helpers.hpp"
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+#include "TimingStatistics.hpp"
+#endif
 
 #include <msp430g2553.h>
 #include <array>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <ratio>
 
 namespace Microtech {
+template<uint8_t TIMER_NUMBER, typename TimerConfig, typename... Tasks>
+class StaticScheduler;
+
 /**
  * Class that serves as a base for a TaskHanlder. The intention of it
  * is since a timer would store different task handlers, it cannot be tamplated
@@ -41,6 +49,9 @@ namespace Microtech {
  *
  */
 class TaskHandlerBase {
+  template<uint8_t TIMER_NUMBER>
+  friend class Timer;
+
 public:
   // using CallbackFunction = std::function<void()>;
   typedef void (*CallbackFunction)();  ///< Type definition of callback
@@ -49,6 +60,8 @@ public:
    * Class constructor.
    * @param callback function pointer to task callback
    * @param isPeriodic To inform weather this is a one-time callback (non periodic) or it is periodic.
+   *                   A non periodic task is removed from the timer right before its callback is called,
+   *                   so it is called only once per registration and stops costing interrupt time.
    */
   TaskHandlerBase(CallbackFunction callback, bool isPeriodic) : taskCallback(callback), isPeriodic(isPeriodic) {}
 
@@ -63,20 +76,56 @@ public:
     }
   }
 
+  /**
+   * @return Number of times the task callback was still running when the task, or in up mode
+   *         the next timer tick, was due again. Saturates at 0xFFFF.
+   */
+  uint16_t getNumOverruns() const noexcept {
+    return numOverruns;
+  }
+
+  void resetNumOverruns() noexcept {
+    numOverruns = 0;
+  }
+
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+  /**
+   * Latency and execution time of the task callback, in timer counts.
+   * The latency is measured from the timer event that made the task due until the callback is called.
+   * Only available when MICROTECH_TIMER_INSTRUMENTATION is defined.
+   */
+  const TimingStatistics<>& getStatistics() const noexcept {
+    return statistics;
+  }
+
+  void resetStatistics() noexcept {
+    statistics.reset();
+  }
+#endif
+
 private:
   const CallbackFunction taskCallback = nullptr;  ///< Callback pointer. Initially null, but can be set on constructor
   const bool isPeriodic;                          ///< Stores if the task is periodic or not
+  uint16_t tickDivisor = 1;    ///< Number of timer base ticks between two calls. Calculated in compile time by the Timer
+  uint16_t ticksUntilDue = 1;  ///< Countdown of base ticks until the task has to be called again
+  uint8_t countedTick = 0;     ///< Timer tick in which the countdown was last updated. Only used in up mode
+  uint32_t periodCounts = 0;   ///< Period in timer counts. Only used in tickless mode
+  uint32_t deadline = 0;       ///< Timer count in which the task is due. Only used in tickless mode
+  uint8_t tableIndex = NOT_REGISTERED;  ///< Index of the task in the timer task table. Allows O(1) removal
+  uint16_t numOverruns = 0;  ///< Number of times the task was due again before its callback returned
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+  TimingStatistics<> statistics;  ///< Timing measurements of the callback
+#endif
+
+  static constexpr uint8_t NOT_REGISTERED = 0xFF;  ///< tableIndex of a task that is not registered in a timer
 };
 
 /**
  * TaskHandler is intended for the user to be able to handle different tasks.
- * At the moment the software supports only one task in the timer, but the advantage
- * of having such class is that later when this is expanded to allow multiple tasks
- * there is no change on the task concept. For example, in continuous mode the MSP supports
- * up to three timer comparators, so one could say that there are three tasks.
- *
- * Software-wise one can eve multiplex the timer and make multiple tasks with one timer
- * interrupt. Like a scheduler.
+ * The period of the task is known in compile time, so when it is registered to a timer
+ * that has a base tick (see TimerConfigBase), the timer calculates in compile time how many
+ * ticks it has to count before calling the task. This way one timer interrupt is multiplexed
+ * between multiple tasks. Like a scheduler.
  *
  * @tparam periodValue Period of the task
  * @tparam Duration Time scale of the period (milliseconds, microseconds...)
@@ -93,6 +142,15 @@ public:
   TaskHandler(CallbackFunction callback, bool isPeriodic) : TaskHandlerBase(callback, isPeriodic) {}
 };
 
+/**
+ * What the timer does when a task callback runs longer than the task period (an overrun).
+ */
+enum class OverrunPolicy {
+  CATCH_UP,  ///< One missed call is made as soon as the callback returns, even if several calls were missed.
+             ///< Then the task continues on its original period grid. The same in all count modes.
+  SKIP,      ///< The missed calls are dropped, the task is next called on its original period grid.
+};
+
 class TimerClockSource {
 public:
     enum class Option {
@@ -113,7 +171,29 @@ public:
     }
 };
 
-template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US>
+/**
+ * Period of one timer count in microseconds, as a compile time fraction.
+ * The timers convert the task periods to counts with it.
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN = 1>
+using TimerCountPeriod = std::ratio<CLK_DIV * SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>;
+
+/**
+ * Class holding the configuration of a timer.
+ *
+ * @tparam CLK_DIV Input divider of the timer clock. Either 1, 2, 4 or 8.
+ * @tparam SOURCE_CLK_PERIOD_US Period of the source clock in microseconds.
+ * @tparam TICK_VALUE Optional base tick of the timer. When it is 0 (default) the period of the registered task
+ *                    is programmed directly in the timer, so the timer holds only one task.
+ *                    When it is set, the timer interrupts every tick and dispatches all registered tasks
+ *                    whose period is a multiple of this tick.
+ * @tparam TickDuration Time scale of the base tick (milliseconds, microseconds...)
+ * @tparam SOURCE_CLK_PERIOD_DEN Optional denominator of the source clock period. The period is
+ *                               SOURCE_CLK_PERIOD_US / SOURCE_CLK_PERIOD_DEN microseconds, so clocks faster than
+ *                               1MHz can be described, e.g. 1 / 16 for 16MHz (see ClockSystem).
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE = 0,
+         typename TickDuration = std::chrono::microseconds, int64_t SOURCE_CLK_PERIOD_DEN = 1>
 class TimerConfigBase {
   template<uint8_t TIMER_NUMBER>
   friend class Timer;
@@ -123,16 +203,70 @@ public:
 protected:
   const TimerClockSource::Option clkSource;
 };
+/**
+ * Class holding the configuration of a timer running in continuous mode.
+ * In this mode the timer counts freely up to 0xFFFF and every registered task gets
+ * its own capture/compare channel (CCR0, CCR1 or CCR2). On each compare interrupt the
+ * channel compare value is advanced by the task period, so up to three tasks with
+ * unrelated periods run on the same timer with exact and independent timing.
+ *
+ * @tparam CLK_DIV Input divider of the timer clock. Either 1, 2, 4 or 8.
+ * @tparam SOURCE_CLK_PERIOD_US Period of the source clock in microseconds.
+ * @tparam SOURCE_CLK_PERIOD_DEN Optional denominator of the source clock period. The period is
+ *                               SOURCE_CLK_PERIOD_US / SOURCE_CLK_PERIOD_DEN microseconds, so clocks faster than
+ *                               1MHz can be described, e.g. 1 / 16 for 16MHz (see ClockSystem).
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN = 1>
+class ContinuousTimerConfig {
+  template<uint8_t TIMER_NUMBER>
+  friend class Timer;
+public:
+  constexpr ContinuousTimerConfig(TimerClockSource::Option clkSource) : clkSource(clkSource) {}
+
+protected:
+  const TimerClockSource::Option clkSource;
+};
+
+/**
+ * Class holding the configuration of a tickless timer.
+ * The timer counts continuously, the registered tasks are kept sorted by their next deadline
+ * and CCR0 is always programmed to the nearest one. So the CPU only wakes up when there is work due,
+ * instead of every tick. Task periods can be longer than one timer overflow, in that case
+ * the timer wakes up once per overflow until the deadline is reached.
+ *
+ * @tparam CLK_DIV Input divider of the timer clock. Either 1, 2, 4 or 8.
+ * @tparam SOURCE_CLK_PERIOD_US Period of the source clock in microseconds.
+ * @tparam SOURCE_CLK_PERIOD_DEN Optional denominator of the source clock period. The period is
+ *                               SOURCE_CLK_PERIOD_US / SOURCE_CLK_PERIOD_DEN microseconds, so clocks faster than
+ *                               1MHz can be described, e.g. 1 / 16 for 16MHz (see ClockSystem).
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN = 1>
+class TicklessTimerConfig {
+  template<uint8_t TIMER_NUMBER>
+  friend class Timer;
+public:
+  constexpr TicklessTimerConfig(TimerClockSource::Option clkSource) : clkSource(clkSource) {}
+
+protected:
+  const TimerClockSource::Option clkSource;
+};
+
 /**
  * Timer class is responsible for managing the timer of MSP430.
  * @tparam TIMER_NUMBER The number of the timer.
  */
 template<uint8_t TIMER_NUMBER>
 class Timer {
-  friend class Pwm;
+  friend class Adc;
+  template<typename>
+  friend class BasicPwm;
+  template<uint8_t, typename, typename...>
+  friend class StaticScheduler;
   using RegisterRef = volatile uint16_t&;
 
 public:
+  typedef void (*OverrunCallback)(TaskHandlerBase& task);  ///< Type definition of the overrun callback
+
   Timer() : TAxCTL(getTAxCTL()), TAxCCR0(getTAxCCR0()), TAxCCTL0(getTAxCCTL0()) {}
   ~Timer() = default;
 
@@ -151,12 +285,39 @@ public:
    * the count type, which IS hard coded. It can also be an argument
    * in the near future.
    */
-  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US>
-  constexpr void init(TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US> config) {
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE, typename TickDuration,
+           int64_t SOURCE_CLK_PERIOD_DEN>
+  constexpr void init(TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_VALUE, TickDuration, SOURCE_CLK_PERIOD_DEN> config) {
     constexpr uint16_t TIMER_INPUT_DIVIDER = getTimerInputDivider<CLK_DIV>();
     // Choose SMCLK as clock source
     // Counting in Up Mode
     TAxCTL = TimerClockSource::getTASSELValue(config.clkSource) + TIMER_INPUT_DIVIDER + MC_0;
+    clearTasks(CountMode::UP);
+  }
+
+  /**
+   * Method to initialize the timer in continuous mode. The mode is only started
+   * when the first task is registered.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN>
+  constexpr void init(ContinuousTimerConfig<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN> config) {
+    constexpr uint16_t TIMER_INPUT_DIVIDER = getTimerInputDivider<CLK_DIV>();
+    TAxCTL = TimerClockSource::getTASSELValue(config.clkSource) + TIMER_INPUT_DIVIDER + MC_0;
+    clearTasks(CountMode::CONTINUOUS);
+  }
+
+  /**
+   * Method to initialize the timer in tickless mode. The timer counter is cleared
+   * and the mode is only started when the first task is registered.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN>
+  constexpr void init(TicklessTimerConfig<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN> config) {
+    constexpr uint16_t TIMER_INPUT_DIVIDER = getTimerInputDivider<CLK_DIV>();
+    TAxCTL = TimerClockSource::getTASSELValue(config.clkSource) + TIMER_INPUT_DIVIDER + MC_0 + TACLR;
+    clearTasks(CountMode::TICKLESS);
+    timeBase = 0;
+    lastCompareValue = 0;
+    programmedStep = 0;
   }
   /**
    * Method to register a task to the timer. It will enable the interrupt of timer 0,
@@ -165,41 +326,74 @@ public:
    * It is an easy interface to setup the timer to a desired interrupt period. E.g.:
    *
    * @code
-   *  Timer timer0;
+   *  // Timer with a base tick of 10ms
+   *  constexpr TimerConfigBase<8, 1, 10, std::chrono::milliseconds> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+   *  Timer<0>::getTimer().init(TIMER_CONFIG);
    *
-   *  // Sets periodic task that is called every 500ms
+   *  // Sets periodic task that is called every 500ms (every 50 ticks)
    *  TaskHandler<500, std::chrono::milliseconds> task1(&task1Callback, true);
-   *  timer0.registerTask(task1);
+   *  Timer<0>::getTimer().registerTask(TIMER_CONFIG, task1);
    *
-   *  // Sets periodic task that is called every 1s
+   *  // Sets periodic task that is called every 1s (every 100 ticks)
    *  TaskHandler<1, std::chrono::seconds> task2(&task2Callback, true);
-   *  timer0.registerTask(task2);
+   *  Timer<0>::getTimer().registerTask(TIMER_CONFIG, task2);
    *
-   *  // Sets non-periodic task that is once 300us from now
-   *  TaskHandler<500, std::chrono::milliseconds> event1(&event1Callback, false);
-   *  timer0.registerTask(event1);
+   *  // Sets non-periodic task that is called once 300ms from now
+   *  TaskHandler<300, std::chrono::milliseconds> event1(&event1Callback, false);
+   *  Timer<0>::getTimer().registerTask(TIMER_CONFIG, event1);
    * @endcode
    *
    * @tparam periodValue The period value in that specific magnitude.
    * @tparam Duration std::chrono duration type.
    *
    * The whole logic ad calculation is done in compile time. The only thing that goes to the binary is the setting of
-   * the registers.
+   * the registers and the tick divisor of the task.
    *
-   * At the moment it is only supported adding one periodic task and no non-periodic
+   * If the config has no base tick (TICK_VALUE = 0), the task period is programmed in the compare register and
+   * the task replaces any other task registered in this timer.
    * Usually when calling the registerTask, the template parameters don't have to be completed,
    * since the compiler can deduce them from the TaskHandler type.
+   *
+   * @return true if the task was registered. False if the task table is already full.
    */
-  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t periodValue, typename Duration = std::chrono::microseconds>
-  constexpr void registerTask(const TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US>& /*config*/, TaskHandler<periodValue, Duration>& task) {
-    // Gets the timer0 compare value
-    constexpr uint16_t COMPARE_VALUE = calculateCompareValue<CLK_DIV, SOURCE_CLK_PERIOD_US, periodValue, Duration>();
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE, typename TickDuration,
+           int64_t SOURCE_CLK_PERIOD_DEN, uint64_t periodValue, typename Duration = std::chrono::microseconds>
+  constexpr bool registerTask(
+    const TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_VALUE, TickDuration, SOURCE_CLK_PERIOD_DEN>& /*config*/,
+    TaskHandler<periodValue, Duration>& task) {
+    constexpr uint64_t TASK_PERIOD_US = toMicroseconds<periodValue, Duration>();
+    // Without base tick the task period itself is the tick.
+    constexpr uint64_t TICK_PERIOD_US = (TICK_VALUE == 0) ? TASK_PERIOD_US : toMicroseconds<TICK_VALUE, TickDuration>();
+    static_assert(TICK_VALUE == 0 || (TASK_PERIOD_US % TICK_PERIOD_US) == 0,
+                  "Task period must be a multiple of the timer base tick");
+    constexpr uint64_t TICK_DIVISOR = (TICK_VALUE == 0) ? 1 : (TASK_PERIOD_US / TICK_PERIOD_US);
+    static_assert(TICK_DIVISOR <= 0xFFFF, "Task period is too long for the timer base tick");
+
+    // Gets the timer compare value
+    constexpr uint16_t COMPARE_VALUE =
+      calculateCompareValue<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_PERIOD_US, std::chrono::microseconds,
+                            SOURCE_CLK_PERIOD_DEN>();
 
-    // For now only one task. This is work in progress.
-    // Task is added to taskHandlers array
-    taskHandlers[0] = &task;
+    CriticalSection criticalSection;  // The interrupt can remove one-shot tasks from the table
+    // Registering a task again restarts its countdown.
+    task.tickDivisor = static_cast<uint16_t>(TICK_DIVISOR);
+    task.ticksUntilDue = task.tickDivisor;
+    task.countedTick = tickNumber;  // If registered from a callback, the current tick does not count for it
 
-    /* Set Timer 0 compare value.
+    if (TICK_VALUE == 0) {
+      // Only one task is allowed, since its period is the timer period.
+      clearTasks(CountMode::UP);
+      placeTask(0, task);
+      numTasks = 1;
+    } else if (!isRegistered(task)) {
+      if (numTasks >= MAX_NUM_TASKS) {
+        return false;
+      }
+      placeTask(numTasks, task);
+      numTasks++;
+    }
+
+    /* Set Timer compare value.
      * One can see that it is the correct value when looking at the disassembly on the call:
      * TaskHandler<500, std::chrono::milliseconds> task1(&task1Callback, true);
      * registerTask(task1); the assembly command is:
@@ -210,32 +404,323 @@ public:
     // Enable interrupt for CCR0.
     setRegisterBits(TAxCCTL0, static_cast<uint16_t>(CCIE));
     setRegisterBits(TAxCTL, static_cast<uint16_t>(MC_1));
+    return true;
+  }
+
+  /**
+   * Method to register a task to a timer in continuous mode. The task gets the first
+   * free capture/compare channel and the channel compare register is advanced by the
+   * task period every time it interrupts. E.g.:
+   *
+   * @code
+   *  constexpr ContinuousTimerConfig<8, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+   *  Timer<1>::getTimer().init(TIMER_CONFIG);
+   *
+   *  TaskHandler<20, std::chrono::milliseconds> samplingTask(&samplingCallback, true);  // Uses CCR0
+   *  TaskHandler<3, std::chrono::milliseconds> debounceTask(&debounceCallback, true);   // Uses CCR1
+   *  Timer<1>::getTimer().registerTask(TIMER_CONFIG, samplingTask);
+   *  Timer<1>::getTimer().registerTask(TIMER_CONFIG, debounceTask);
+   * @endcode
+   *
+   * The compare increment is calculated in compile time.
+   *
+   * @return true if the task was registered. False if all compare channels are already in use.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN, uint64_t periodValue,
+           typename Duration = std::chrono::microseconds>
+  bool registerTask(const ContinuousTimerConfig<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>& /*config*/,
+                    TaskHandler<periodValue, Duration>& task) {
+    // In continuous mode the compare register is advanced, so there is no -1 as in up mode.
+    constexpr uint64_t COMPARE_INCREMENT =
+      toCounts<TimerCountPeriod<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>>(
+        toMicroseconds<periodValue, Duration>());
+    static_assert(COMPARE_INCREMENT > 0 && COMPARE_INCREMENT <= 0xFFFF,
+                  "Cannot set desired task period. It must be between one timer count and the counter maximum value");
+
+    CriticalSection criticalSection;
+    // A task that is registered again keeps its channel and restarts its period.
+    uint8_t channel = isRegistered(task) ? task.tableIndex : 0;
+    while (channel < NUM_COMPARE_CHANNELS &&
+           ((taskHandlers[channel] != nullptr && taskHandlers[channel] != &task) || captureHandlers[channel] != nullptr)) {
+      channel++;
+    }
+    if (channel == NUM_COMPARE_CHANNELS) {
+      return false;
+    }
+    compareIncrements[channel] = static_cast<uint16_t>(COMPARE_INCREMENT);
+    placeTask(channel, task);
+    getTAxCCRn(channel) = getTAxR() + static_cast<uint16_t>(COMPARE_INCREMENT);
+    getTAxCCTLn(channel) = CCIE;
+    setRegisterBits(TAxCTL, static_cast<uint16_t>(MC_2));
+    return true;
+  }
+
+  /**
+   * Method to register a task to a tickless timer. E.g.:
+   *
+   * @code
+   *  constexpr TicklessTimerConfig<8, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+   *  Timer<1>::getTimer().init(TIMER_CONFIG);
+   *
+   *  TaskHandler<20, std::chrono::milliseconds> samplingTask(&samplingCallback, true);
+   *  TaskHandler<2, std::chrono::seconds> displayTask(&displayCallback, true);
+   *  Timer<1>::getTimer().registerTask(TIMER_CONFIG, samplingTask);
+   *  Timer<1>::getTimer().registerTask(TIMER_CONFIG, displayTask);
+   * @endcode
+   *
+   * The period in timer counts is calculated in compile time. The first deadline of the task
+   * is one period after its registration. Registering a task again restarts its deadline.
+   *
+   * @return true if the task was registered. False if the task table is already full.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN, uint64_t periodValue,
+           typename Duration = std::chrono::microseconds>
+  bool registerTask(const TicklessTimerConfig<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>& /*config*/,
+                    TaskHandler<periodValue, Duration>& task) {
+    constexpr uint64_t PERIOD_COUNTS = toCounts<TimerCountPeriod<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>>(
+      toMicroseconds<periodValue, Duration>());
+    // Deadlines are compared with a signed difference, so the period must fit in 31 bits.
+    static_assert(PERIOD_COUNTS > 0 && PERIOD_COUNTS <= 0x7FFFFFFF,
+                  "Cannot set desired task period. It must be between one timer count and 2^31 timer counts");
+
+    CriticalSection criticalSection;  // The interrupt also sorts the task table
+    if (isRegistered(task)) {
+      removeTask(task);
+    }
+    if (numTasks >= MAX_NUM_TASKS) {
+      return false;
+    }
+    const bool timerRunning = getRegisterBits(TAxCTL, static_cast<uint16_t>(MC_3), static_cast<uint16_t>(4)) != 0;
+    if (!timerRunning) {
+      lastCompareValue = getTAxR();
+    }
+    const uint32_t now = timeBase + static_cast<uint16_t>(getTAxR() - lastCompareValue);
+
+    task.periodCounts = static_cast<uint32_t>(PERIOD_COUNTS);
+    task.deadline = now + task.periodCounts;
+    placeTask(numTasks, task);
+    numTasks++;
+    sortTaskUp(numTasks - 1);
+
+    // Only the nearest deadline matters for the compare register.
+    const bool interruptEnabled = (TAxCCTL0 & CCIE) != 0;
+    if (!timerRunning || !interruptEnabled || taskHandlers[0] == &task) {
+      programNextDeadline();
+    }
+    if (!interruptEnabled) {
+      // Writing the register also clears an old pending compare flag.
+      TAxCCTL0 = CCIE;
+    }
+    if (!timerRunning) {
+      setRegisterBits(TAxCTL, static_cast<uint16_t>(MC_2));
+    }
+    return true;
+  }
+
+  /**
+   * Method to change the period of a timer in up mode at runtime, without a template instantiation per period.
+   * E.g. to synthesize tones whose frequency is only known at runtime. If the config has a base tick, the tick
+   * is changed and so are the periods of all registered tasks, since their tick divisors stay the same.
+   *
+   * The MSP430G2553 has no hardware divider, so the microseconds are converted to timer counts with a shift or
+   * a multiplication by the reciprocal of the count period (see microsecondsToCounts()).
+   *
+   * @param periodUs The new period in microseconds
+   * @return true if the period was set. False if the timer is not in up mode or if the period
+   *         is shorter than one timer count or longer than the counter range.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t TICK_VALUE, typename TickDuration,
+           int64_t SOURCE_CLK_PERIOD_DEN>
+  bool setPeriod(
+    const TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US, TICK_VALUE, TickDuration, SOURCE_CLK_PERIOD_DEN>& /*config*/,
+    uint32_t periodUs) {
+    const uint32_t periodCounts =
+      microsecondsToCounts<TimerCountPeriod<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>>(periodUs);
+    if (countMode != CountMode::UP || periodCounts == 0 || periodCounts > 0x10000) {
+      return false;
+    }
+    // If the new value is smaller than the current count, the timer restarts from 0.
+    TAxCCR0 = static_cast<uint16_t>(periodCounts - 1);
+    setRegisterBits(TAxCTL, static_cast<uint16_t>(MC_1));
+    return true;
   }
 
   constexpr void stop() {
     resetRegisterBits(TAxCTL, static_cast<uint16_t>(MC_3));
     resetRegisterBits(TAxCCTL0, static_cast<uint16_t>(CCIE));
+    if (countMode == CountMode::CONTINUOUS) {
+      resetRegisterBits(getTAxCCTLn(1), static_cast<uint16_t>(CCIE));
+      resetRegisterBits(getTAxCCTLn(2), static_cast<uint16_t>(CCIE));
+    }
   }
   /**
-   * Method to deregister a task. But not yet implemented
-   * @param taskHandler Takes the reference of the taskHandler.
+   * Method to register a Capture in the channel CCR1 or CCR2 of a timer in continuous mode.
+   * The channel is configured in capture mode with the input CCIxA, synchronized with the timer clock.
+   * The pin has to be configured by the application (see IOFunctionality).
+   *
+   * @tparam CHANNEL Capture/compare channel. Either 1 or 2.
+   * @return true if the capture was registered. False if a task is already using the channel.
    */
-  bool deregisterTask(TaskHandlerBase& /*taskHandler*/) {
-    // static_assert(false, "Function not yet implemented");
+  template<uint8_t CHANNEL, int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN,
+           uint8_t BUFFER_SIZE>
+  bool registerCapture(const ContinuousTimerConfig<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>& /*config*/,
+                       Capture<CLK_DIV, SOURCE_CLK_PERIOD_US, BUFFER_SIZE, SOURCE_CLK_PERIOD_DEN>& capture) {
+    static_assert(CHANNEL == 1 || CHANNEL == 2, "Captures can only use the channels CCR1 and CCR2");
+    return placeCapture(CHANNEL, capture);
+  }
+
+  /**
+   * Method to register a Capture in the channel CCR1 or CCR2 of a tickless timer.
+   * The tickless mode only uses CCR0, so both channels are always free.
+   */
+  template<uint8_t CHANNEL, int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN,
+           uint8_t BUFFER_SIZE>
+  bool registerCapture(const TicklessTimerConfig<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>& /*config*/,
+                       Capture<CLK_DIV, SOURCE_CLK_PERIOD_US, BUFFER_SIZE, SOURCE_CLK_PERIOD_DEN>& capture) {
+    static_assert(CHANNEL == 1 || CHANNEL == 2, "Captures can only use the channels CCR1 and CCR2");
+    return placeCapture(CHANNEL, capture);
+  }
+
+  /**
+   * Method to deregister a capture. The channel is disabled.
+   * @return true if the capture was removed. False if it was not registered in this timer.
+   */
+  bool deregisterCapture(CaptureHandlerBase& capture) {
+    CriticalSection criticalSection;
+    for (uint8_t channel = 1; channel < NUM_COMPARE_CHANNELS; channel++) {
+      if (captureHandlers[channel] == &capture) {
+        getTAxCCTLn(channel) = 0;
+        captureHandlers[channel] = nullptr;
+        return true;
+      }
+    }
     return false;
   }
 
+  /**
+   * Sets what happens with the calls missed due to an overrun. The default is OverrunPolicy::CATCH_UP.
+   * In up mode all tasks share the timer tick, so skipping drops the missed tick for all of them.
+   */
+  void setOverrunPolicy(OverrunPolicy policy) noexcept {
+    overrunPolicy = policy;
+  }
+
+  /**
+   * Sets a function that is called by the timer interrupt every time a task overruns.
+   * It receives the task whose callback was running when the next call became due.
+   * @param callback function pointer. nullptr disables the hook.
+   */
+  void setOverrunCallback(OverrunCallback callback) noexcept {
+    overrunCallback = callback;
+  }
+
+  /**
+   * Method to deregister a task. The task stores its index in the task table, so the removal
+   * does not need to search the table. It can also be called from within a task callback.
+   * @param taskHandler Takes the reference of the taskHandler.
+   * @return true if the task was removed. False if it was not registered in this timer.
+   */
+  bool deregisterTask(TaskHandlerBase& taskHandler) {
+    CriticalSection criticalSection;
+    if (!isRegistered(taskHandler)) {
+      return false;
+    }
+    removeTask(taskHandler);
+    return true;
+  }
+
   /**
    * Function must be called by the timer interrupt.
    *
+   * When MICROTECH_TIMER_INSTRUMENTATION is defined, the timer counter is read on entry and exit,
+   * so the latency of the interrupt and the time spent in it are measured (see getInterruptStatistics()).
+   * The tasks measure their own callbacks as well (see TaskHandlerBase::getStatistics()).
+   *
    * @note There must be a better way of doing this. Maybe encapsulating
    * this function or setting durin runtime the interrupt function
    * to a private method of the Timer instance. Need to figure this out.
    */
   inline void interruptionHappened() {
-    taskHandlers[0]->callCallback();
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+    const uint16_t entryCount = getTAxR();
+    // In up mode the event is the counter restarting from 0. Otherwise it is the CCR0 compare value.
+    const uint16_t eventCount = (countMode == CountMode::UP) ? 0 : TAxCCR0;
+#endif
+    if (countMode == CountMode::CONTINUOUS) {
+      compareInterruptionHappened(0);
+    } else if (countMode == CountMode::TICKLESS) {
+      ticklessInterruptionHappened();
+    } else {
+      tickInterruptionHappened();
+    }
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+    interruptStatistics.record(elapsedCounts(eventCount, entryCount), elapsedCounts(entryCount, getTAxR()));
+#endif
+  }
+
+  /**
+   * Function must be called by the TIMERx_A1 interrupt. It handles the CCR1 and CCR2
+   * channels used by captures and continuous mode tasks and the counter overflow used by the uptime.
+   * Reading TAxIV returns the highest priority pending interrupt and clears its flag.
+   */
+  inline void vectorInterruptionHappened() {
+    switch (__even_in_range(getTAxIV(), TA0IV_TAIFG)) {
+      case TA0IV_TACCR1: channelInterruptionHappened(1); break;
+      case TA0IV_TACCR2: channelInterruptionHappened(2); break;
+      case TA0IV_TAIFG: numOverflows = numOverflows + 1; break;
+      default: break;
+    }
+  }
+
+  /**
+   * Method to start extending the 16 bits counter with the overflow interrupt, so the timer
+   * can be used as a free running clock (see getUptimeCounts() and UptimeClock).
+   * It must be called after init(), since init() rewrites the control register. If no task
+   * is registered yet, the timer is started in continuous mode.
+   * @return true if the uptime was started. False in up mode, where the counter does not run up to 0xFFFF.
+   */
+  bool startUptime() {
+    if (countMode == CountMode::UP) {
+      return false;
+    }
+    CriticalSection criticalSection;
+    numOverflows = 0;
+    resetRegisterBits(TAxCTL, static_cast<uint16_t>(TAIFG));
+    setRegisterBits(TAxCTL, static_cast<uint16_t>(TAIE | MC_2));
+    return true;
   }
 
+  /**
+   * Method to read the timer counter extended by the number of overflows.
+   * An overflow can happen while the value is read, or it can be pending because the interrupts are disabled
+   * (e.g. when called from another interrupt). If the overflow flag is set and the counter is in its lower half,
+   * the overflow happened before the counter was read and is added here.
+   * @return Timer counts since the uptime was started. It has 48 significant bits.
+   */
+  uint64_t getUptimeCounts() const {
+    CriticalSection criticalSection;
+    uint32_t overflows = numOverflows;
+    const uint16_t count = getTAxR();
+    if ((TAxCTL & TAIFG) != 0 && count < 0x8000) {
+      overflows++;
+    }
+    return (static_cast<uint64_t>(overflows) << 16) | count;
+  }
+
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+  /**
+   * Latency and execution time of the CCR0 interrupt, in timer counts.
+   * Only available when MICROTECH_TIMER_INSTRUMENTATION is defined.
+   */
+  const TimingStatistics<>& getInterruptStatistics() const noexcept {
+    return interruptStatistics;
+  }
+
+  void resetInterruptStatistics() noexcept {
+    interruptStatistics.reset();
+  }
+#endif
+
 protected:
   /**
    * Function to calculate the TACCRx value.
@@ -243,7 +728,8 @@ protected:
    * this doesn't result in a function call during runtime and it is
    * evaluated in compile time resulting in just a number in the program binary.
    */
-  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t periodValue, typename Duration = std::chrono::microseconds>
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t periodValue,
+           typename Duration = std::chrono::microseconds, int64_t SOURCE_CLK_PERIOD_DEN = 1>
   static constexpr uint16_t calculateCompareValue() {
     // Declares the duration given by the user and then converts it to microseconds
     // !! Duration is a type and periodValue is a value !!
@@ -251,12 +737,12 @@ protected:
     constexpr std::chrono::microseconds PERIOD_IN_US = PERIOD;
 
     /*
-     * Internal clock is 1 MHz, according to templateEMP.h
-     *
-     * So the compare value is basically the (period[us] / (1us * clockDiv)) - 1. The -1 because the counter starts in 0
+     * The compare value is basically the (period[us] / (source clock period[us] * clockDiv)) - 1.
+     * The -1 because the counter starts in 0
      * !!!! Since all the values are constants, the division is evaluated in compile time. !!!!!
      */
-    constexpr int64_t COMPARE_VALUE = (PERIOD_IN_US.count() / (CLK_DIV*SOURCE_CLK_PERIOD_US)) - 1;
+    constexpr int64_t COMPARE_VALUE = static_cast<int64_t>(
+      toCounts<TimerCountPeriod<CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>>(PERIOD_IN_US.count())) - 1;
 
     // Static assert so if the compareValue is bigger than 0xFFFF the compiler gives an error. This is not added as
     // instructions in the binary. One could verify that it works by calling "setupTimer0<5, std::chrono::seconds>();".
@@ -265,6 +751,394 @@ protected:
   }
 
 private:
+  /**
+   * Converts a period to microseconds. Evaluated in compile time.
+   */
+  template<uint64_t periodValue, typename Duration>
+  static constexpr uint64_t toMicroseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Duration(periodValue)).count());
+  }
+
+  /**
+   * Converts microseconds to timer counts. Evaluated in compile time.
+   * @tparam CountPeriod Period of one timer count in microseconds, as a std::ratio (see TimerCountPeriod).
+   */
+  template<typename CountPeriod>
+  static constexpr uint64_t toCounts(uint64_t periodUs) {
+    return (periodUs * CountPeriod::den) / CountPeriod::num;
+  }
+
+  /**
+   * Converts microseconds to timer counts without a division. The count period is known in compile time:
+   * if its numerator is a power of two the conversion is a shift, otherwise the value is multiplied by the
+   * reciprocal 2^32 / numerator (rounded up) and the upper 32 bits are taken. Inside the counter range the
+   * result is exact for count periods shorter than 256us.
+   * @tparam CountPeriod Period of one timer count in microseconds, as a std::ratio (see TimerCountPeriod).
+   */
+  template<typename CountPeriod>
+  static uint32_t microsecondsToCounts(uint32_t periodUs) {
+    constexpr uint64_t NUM = CountPeriod::num;
+    constexpr uint64_t DEN = CountPeriod::den;
+    static_assert(NUM > 0 && NUM <= 0xFFFFFFFF && DEN <= 0xFFFF, "Invalid timer count period");
+    if (periodUs > (UINT32_MAX / DEN)) {
+      return UINT32_MAX;  // Far beyond the counter range
+    }
+    const uint32_t scaledPeriod = periodUs * static_cast<uint32_t>(DEN);  // A shift when DEN is a power of two
+    constexpr bool IS_POWER_OF_TWO = (NUM & (NUM - 1)) == 0;
+    if (IS_POWER_OF_TWO) {
+      return scaledPeriod >> floorLog2(NUM);
+    }
+    constexpr uint64_t RECIPROCAL = ((1ULL << 32) + NUM - 1) / NUM;
+    return static_cast<uint32_t>((static_cast<uint64_t>(scaledPeriod) * RECIPROCAL) >> 32);
+  }
+
+  /**
+   * Base 2 logarithm rounded down. Evaluated in compile time.
+   */
+  static constexpr uint8_t floorLog2(uint64_t value) {
+    return (value <= 1) ? 0 : static_cast<uint8_t>(1 + floorLog2(value >> 1));
+  }
+
+  /**
+   * Enum with the count modes supported by the timer.
+   */
+  enum class CountMode {
+    UP,          ///< Timer counts up to CCR0 and the tasks are dispatched based on the base tick.
+    CONTINUOUS,  ///< Timer counts up to 0xFFFF and each task has its own compare channel.
+    TICKLESS,    ///< Timer counts up to 0xFFFF and CCR0 is programmed to the nearest task deadline.
+  };
+
+  /**
+   * Removes all the tasks of the timer and sets the count mode the tasks will be registered with.
+   */
+  void clearTasks(CountMode newMode) {
+    for (TaskHandlerBase* task : taskHandlers) {
+      if (task != nullptr) {
+        task->tableIndex = TaskHandlerBase::NOT_REGISTERED;
+      }
+    }
+    countMode = newMode;
+    numTasks = 0;
+    taskHandlers.fill(nullptr);
+  }
+
+  /**
+   * Writes the task in the index of the task table and lets the task know its index.
+   */
+  void placeTask(uint8_t index, TaskHandlerBase& task) {
+    taskHandlers[index] = &task;
+    task.tableIndex = index;
+  }
+
+  /**
+   * Removes a registered task from the task table. Must be called with the interrupts disabled
+   * or from the timer interrupt.
+   *  * Continuous mode: The channel of the task is freed and its interrupt is disabled.
+   *  * Up mode: The last task of the table takes the index of the removed task.
+   *  * Tickless mode: The following tasks are moved one index to the front, so the table stays sorted.
+   *    This is bounded by MAX_NUM_TASKS.
+   * When the last task is removed the CCR0 interrupt is disabled, so an idle timer costs no interrupt time.
+   */
+  void removeTask(TaskHandlerBase& task) {
+    const uint8_t index = task.tableIndex;
+    task.tableIndex = TaskHandlerBase::NOT_REGISTERED;
+
+    if (countMode == CountMode::CONTINUOUS) {
+      resetRegisterBits(getTAxCCTLn(index), static_cast<uint16_t>(CCIE));
+      taskHandlers[index] = nullptr;
+      return;
+    }
+
+    numTasks--;
+    if (countMode == CountMode::TICKLESS) {
+      for (uint8_t i = index; i < numTasks; i++) {
+        placeTask(i, *taskHandlers[i + 1]);
+      }
+    } else if (index != numTasks) {
+      placeTask(index, *taskHandlers[numTasks]);
+    }
+    taskHandlers[numTasks] = nullptr;
+
+    if (numTasks == 0) {
+      resetRegisterBits(TAxCCTL0, static_cast<uint16_t>(CCIE));
+    }
+  }
+
+  /**
+   * Handles the CCR0 interrupt in up mode. Only the tasks that are due in this tick are called.
+   * The compare flag is cleared when the interrupt is served, so if it is set again after a callback
+   * the next tick already happened: that task overran.
+   *
+   * A callback can register or remove tasks, which moves tasks to other indexes of the table. So each task
+   * is marked with the tick in which it was counted, and the table is scanned again from the start after
+   * every callback. Like that every task is counted exactly once per tick, and a task registered by a
+   * callback is only counted from the next tick on. The table has at most MAX_NUM_TASKS entries.
+   */
+  inline void tickInterruptionHappened() {
+    const uint8_t currentTick = ++tickNumber;
+    bool tickMissed = false;
+    uint8_t i = 0;
+    while (i < numTasks) {
+      TaskHandlerBase& task = *taskHandlers[i];
+      if (task.countedTick == currentTick) {
+        i++;
+        continue;
+      }
+      task.countedTick = currentTick;
+      if (--task.ticksUntilDue == 0) {
+        task.ticksUntilDue = task.tickDivisor;
+        if (!task.isPeriodic) {
+          removeTask(task);  // Removed before the call, so the callback can register it again
+        }
+        callTask(task, 0);
+        if (!tickMissed && (TAxCCTL0 & CCIFG) != 0) {
+          if (overrunPolicy == OverrunPolicy::SKIP) {
+            resetRegisterBits(TAxCCTL0, static_cast<uint16_t>(CCIFG));
+          } else {
+            tickMissed = true;  // The pending flag stays, so the following callbacks cannot be blamed for it
+          }
+          taskOverran(task);
+        }
+        i = 0;  // The callback may have changed the table. The tasks already counted are skipped
+        continue;
+      }
+      i++;
+    }
+  }
+
+  /**
+   * Calls the task callback. With MICROTECH_TIMER_INSTRUMENTATION the timer counter is read
+   * before and after the call and the task statistics are updated.
+   * @param eventCount Timer count of the event that made the task due
+   */
+  inline void callTask(TaskHandlerBase& task, uint16_t eventCount) {
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+    const uint16_t startCount = getTAxR();
+    task.callCallback();
+    task.statistics.record(elapsedCounts(eventCount, startCount), elapsedCounts(startCount, getTAxR()));
+#else
+    (void)eventCount;
+    task.callCallback();
+#endif
+  }
+
+  /**
+   * Counts the overrun of the task and calls the overrun hook.
+   */
+  void taskOverran(TaskHandlerBase& task) {
+    if (task.numOverruns < UINT16_MAX) {
+      task.numOverruns++;
+    }
+    if (overrunCallback != nullptr) {
+      overrunCallback(task);
+    }
+  }
+
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+  /**
+   * Timer counts from one count to another. In up mode the counter restarts after CCR0,
+   * so a wrap adds the CCR0 period. In the other modes it wraps at 0xFFFF, which the 16 bits subtraction handles.
+   */
+  uint16_t elapsedCounts(uint16_t fromCount, uint16_t toCount) const {
+    uint16_t elapsed = toCount - fromCount;
+    if (countMode == CountMode::UP && toCount < fromCount) {
+      elapsed += TAxCCR0 + 1;
+    }
+    return elapsed;
+  }
+#endif
+
+  /**
+   * Puts a capture in a channel and configures the channel in capture mode. The timer is started in
+   * continuous mode if it is not running yet.
+   */
+  bool placeCapture(uint8_t channel, CaptureHandlerBase& capture) {
+    CriticalSection criticalSection;
+    if (captureHandlers[channel] != nullptr && captureHandlers[channel] != &capture) {
+      return false;
+    }
+    if (countMode == CountMode::CONTINUOUS && taskHandlers[channel] != nullptr) {
+      return false;
+    }
+    capture.reset();
+    captureHandlers[channel] = &capture;
+    getTAxCCTLn(channel) = capture.getCaptureModeBits() + CCIS_0 + SCS + CAP + CCIE;
+    setRegisterBits(TAxCTL, static_cast<uint16_t>(MC_2));
+    return true;
+  }
+
+  /**
+   * Handles the interrupt of the channel CCR1 or CCR2, which is either used by a capture or by a task.
+   */
+  inline void channelInterruptionHappened(uint8_t channel) {
+    CaptureHandlerBase* capture = captureHandlers[channel];
+    if (capture == nullptr) {
+      compareInterruptionHappened(channel);
+      return;
+    }
+    RegisterRef TAxCCTLn = getTAxCCTLn(channel);
+    const uint16_t captureValue = getTAxCCRn(channel);
+    const bool edgeLost = (TAxCCTLn & COV) != 0;
+    if (edgeLost) {
+      resetRegisterBits(TAxCCTLn, static_cast<uint16_t>(COV));
+    }
+    capture->captureHappened(captureValue, (TAxCCTLn & CCI) != 0, edgeLost);
+  }
+
+  /**
+   * Handles the interrupt of one compare channel in continuous mode.
+   * The compare register is advanced by the task period, so the next interrupt
+   * does not depend on how late this one was served.
+   *
+   * If the counter passed the next compare value before the callback returned, the task overran.
+   * The compare may even have been passed before it was written, and then the interrupt would only
+   * happen after a whole counter overflow. So for skipping the compare is advanced by whole periods until
+   * it is in the future again. For catching up it is advanced to the last missed period and the flag is
+   * set by software: the task is called once right away, which moves the compare back on the period grid.
+   */
+  inline void compareInterruptionHappened(uint8_t channel) {
+    TaskHandlerBase& task = *taskHandlers[channel];
+    const uint16_t compareValue = getTAxCCRn(channel);
+    const uint16_t increment = compareIncrements[channel];
+    if (task.isPeriodic) {
+      getTAxCCRn(channel) = compareValue + increment;
+    } else {
+      removeTask(task);
+    }
+    callTask(task, compareValue);
+
+    if (!task.isPeriodic || taskHandlers[channel] != &task) {
+      return;
+    }
+    const uint16_t elapsedCounts = getTAxR() - compareValue;
+    if (elapsedCounts < increment) {
+      return;
+    }
+    uint32_t nextCompareOffset = static_cast<uint32_t>(increment) * 2;
+    while (nextCompareOffset <= elapsedCounts) {
+      nextCompareOffset += increment;
+    }
+    if (overrunPolicy == OverrunPolicy::SKIP) {
+      resetRegisterBits(getTAxCCTLn(channel), static_cast<uint16_t>(CCIFG));
+      getTAxCCRn(channel) = compareValue + static_cast<uint16_t>(nextCompareOffset);
+    } else {
+      getTAxCCRn(channel) = compareValue + static_cast<uint16_t>(nextCompareOffset - increment);
+      setRegisterBits(getTAxCCTLn(channel), static_cast<uint16_t>(CCIFG));
+    }
+    taskOverran(task);
+  }
+
+  /**
+   * Handles the CCR0 interrupt in tickless mode.
+   * The interrupt happens exactly at the programmed compare value, so the time base is advanced by
+   * the programmed step. All tasks that are due are called, rescheduled and sorted again,
+   * then the compare register is programmed to the next deadline.
+   *
+   * If the next deadline of a task has already passed when its callback returns, the task overran.
+   * For skipping the deadline is advanced by whole periods until it is in the future again. For catching
+   * up it is advanced to the last missed period, which is still in the past, so the task is called once
+   * right away and then continues on its period grid.
+   */
+  inline void ticklessInterruptionHappened() {
+    timeBase += programmedStep;
+    lastCompareValue = TAxCCR0;
+
+    while (numTasks > 0 && isBefore(taskHandlers[0]->deadline, timeBase + 1)) {
+      TaskHandlerBase& task = *taskHandlers[0];
+      if (task.isPeriodic) {
+        task.deadline += task.periodCounts;
+        sortTaskDown(0);
+      } else {
+        removeTask(task);
+      }
+      callTask(task, lastCompareValue);
+
+      if (task.isPeriodic && isRegistered(task)) {
+        const uint32_t now = timeBase + static_cast<uint16_t>(getTAxR() - lastCompareValue);
+        if (isBefore(task.deadline, now + 1)) {
+          if (overrunPolicy == OverrunPolicy::SKIP) {
+            while (isBefore(task.deadline, now + 1)) {
+              task.deadline += task.periodCounts;
+            }
+          } else {
+            while (isBefore(task.deadline + task.periodCounts, now + 1)) {
+              task.deadline += task.periodCounts;
+            }
+          }
+          sortTaskDown(task.tableIndex);
+          taskOverran(task);
+        }
+      }
+    }
+    programNextDeadline();
+  }
+
+  /**
+   * Programs CCR0 to the nearest deadline. If the deadline is further away than a timer
+   * overflow, an intermediate wake-up is programmed. If the deadline has already passed while
+   * the tasks were executed, the compare is programmed a few counts after the current count,
+   * otherwise the interrupt would only happen after a complete timer overflow.
+   */
+  void programNextDeadline() {
+    uint32_t step = MAX_TICKLESS_STEP;
+    if (numTasks > 0) {
+      const uint32_t countsUntilDeadline = taskHandlers[0]->deadline - timeBase;
+      if (countsUntilDeadline < step) {
+        step = countsUntilDeadline;
+      }
+    }
+    const uint16_t elapsedCounts = getTAxR() - lastCompareValue;
+    if (step < static_cast<uint32_t>(elapsedCounts) + MIN_TICKLESS_STEP) {
+      step = static_cast<uint32_t>(elapsedCounts) + MIN_TICKLESS_STEP;
+    }
+    programmedStep = static_cast<uint16_t>(step);
+    TAxCCR0 = lastCompareValue + programmedStep;
+  }
+
+  /**
+   * Checks if a deadline is before another one. The signed difference handles the
+   * overflow of the 32 bits time base.
+   */
+  static constexpr bool isBefore(uint32_t deadline, uint32_t otherDeadline) {
+    return static_cast<int32_t>(deadline - otherDeadline) < 0;
+  }
+
+  /**
+   * Moves the task in the index towards the beginning of the table until the table is sorted by deadline.
+   */
+  void sortTaskUp(uint8_t index) {
+    while (index > 0 && isBefore(taskHandlers[index]->deadline, taskHandlers[index - 1]->deadline)) {
+      swapTasks(index, index - 1);
+      index--;
+    }
+  }
+
+  /**
+   * Moves the task in the index towards the end of the table until the table is sorted by deadline.
+   */
+  void sortTaskDown(uint8_t index) {
+    while ((index + 1) < numTasks && isBefore(taskHandlers[index + 1]->deadline, taskHandlers[index]->deadline)) {
+      swapTasks(index, index + 1);
+      index++;
+    }
+  }
+
+  /**
+   * Swaps the tasks of two indexes of the task table.
+   */
+  void swapTasks(uint8_t index, uint8_t otherIndex) {
+    TaskHandlerBase& task = *taskHandlers[index];
+    placeTask(index, *taskHandlers[otherIndex]);
+    placeTask(otherIndex, task);
+  }
+
+  /**
+   * Checks if the task is registered in this timer.
+   */
+  bool isRegistered(const TaskHandlerBase& task) const {
+    return task.tableIndex < MAX_NUM_TASKS && taskHandlers[task.tableIndex] == &task;
+  }
+
   /**
    * Method to get the correct value of the timer interrupt
    * Divider given in the template parameter of this class.
@@ -311,13 +1185,67 @@ private:
     return TA0CCTL0;
   }
 
+  static RegisterRef getTAxR() {
+    switch (TIMER_NUMBER) {
+      case 0: return TA0R;
+      case 1: return TA1R;
+    };
+    return TA0R;
+  }
+
+  static RegisterRef getTAxIV() {
+    switch (TIMER_NUMBER) {
+      case 0: return TA0IV;
+      case 1: return TA1IV;
+    };
+    return TA0IV;
+  }
+
+  static RegisterRef getTAxCCRn(uint8_t channel) {
+    switch (channel) {
+      case 1: return (TIMER_NUMBER == 0) ? TA0CCR1 : TA1CCR1;
+      case 2: return (TIMER_NUMBER == 0) ? TA0CCR2 : TA1CCR2;
+      default: return getTAxCCR0();
+    };
+  }
+
+  static RegisterRef getTAxCCTLn(uint8_t channel) {
+    switch (channel) {
+      case 1: return (TIMER_NUMBER == 0) ? TA0CCTL1 : TA1CCTL1;
+      case 2: return (TIMER_NUMBER == 0) ? TA0CCTL2 : TA1CCTL2;
+      default: return getTAxCCTL0();
+    };
+  }
+
+  static constexpr uint8_t MAX_NUM_TASKS = 4;         ///< Maximum number of tasks a timer can dispatch.
+  static constexpr uint8_t NUM_COMPARE_CHANNELS = 3;  ///< Number of capture/compare channels of a Timer_A3
+  static constexpr uint32_t MAX_TICKLESS_STEP = 0xFFFF;  ///< Longest time between two wake-ups in tickless mode
+  static constexpr uint32_t MIN_TICKLESS_STEP = 2;  ///< Counts needed so a compare is not programmed in the past
+
   /**
    * List of the task handlers registered to the timer.
-   *
-   * For now it is only one, but the container is there already so later it is easier
-   * to update the code. And also doesn't add much extra overhead or memory.
+   * Only the first numTasks entries are valid.
    */
-  std::array<TaskHandlerBase*, 1> taskHandlers;
+  std::array<TaskHandlerBase*, MAX_NUM_TASKS> taskHandlers{};
+  uint8_t numTasks = 0;  ///< Number of tasks registered in the taskHandlers
+  uint8_t tickNumber = 0;  ///< Number of the current tick in up mode. Wraps around
+  CountMode countMode = CountMode::UP;  ///< Count mode the timer was initialized with
+  /**
+   * Compare increment of each channel in continuous mode. In this mode the entry of
+   * taskHandlers with the same index holds the task of the channel.
+   */
+  std::array<uint16_t, NUM_COMPARE_CHANNELS> compareIncrements{};
+  std::array<CaptureHandlerBase*, NUM_COMPARE_CHANNELS> captureHandlers{};  ///< Captures of CCR1 and CCR2
+  uint32_t timeBase = 0;          ///< Tickless mode: timer counts elapsed until the last compare interrupt
+  uint16_t lastCompareValue = 0;  ///< Tickless mode: value of CCR0 in the last compare interrupt
+  uint16_t programmedStep = 0;    ///< Tickless mode: counts between the last and the next compare interrupt
+  volatile uint32_t numOverflows = 0;  ///< Number of counter overflows since startUptime()
+  OverrunPolicy overrunPolicy = OverrunPolicy::CATCH_UP;  ///< What happens with the calls missed due to an overrun
+  OverrunCallback overrunCallback = nullptr;               ///< Hook called when a task overruns
+#ifdef MICROTECH_TIMER_INSTRUMENTATION
+  TimingStatistics<> interruptStatistics;  ///< Timing measurements of the CCR0 interrupt
+#endif
+
   RegisterRef TAxCTL;
   RegisterRef TAxCCR0;
   RegisterRef TAxCCTL0;
@@ -325,16 +1253,33 @@ private:
 
 } /* namespace Microtech */
 
+// The CCR0 interrupts can be defined by the application, e.g. to forward them to a StaticScheduler.
+#ifndef MICROTECH_CUSTOM_TIMER0_A0_ISR
 // Timer0 Interruption
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void Timer_A_CCR0_ISR(void) {
   Microtech::Timer<0>::getTimer().interruptionHappened();
 }
+#endif
 
+#ifndef MICROTECH_CUSTOM_TIMER1_A0_ISR
 // Timer1 Interruption
 #pragma vector = TIMER1_A0_VECTOR
 __interrupt void Timer1_A_CCR0_ISR(void) {
   Microtech::Timer<1>::getTimer().interruptionHappened();
 }
+#endif
+
+// Timer0 CCR1, CCR2 and overflow Interruption
+#pragma vector = TIMER0_A1_VECTOR
+__interrupt void Timer_A_TAIV_ISR(void) {
+  Microtech::Timer<0>::getTimer().vectorInterruptionHappened();
+}
+
+// Timer1 CCR1, CCR2 and overflow Interruption
+#pragma vector = TIMER1_A1_VECTOR
+__interrupt void Timer1_A_TAIV_ISR(void) {
+  Microtech::Timer<1>::getTimer().vectorInterruptionHappened();
+}
 
 #endif /* COMMON_TIMER_HPP_ */
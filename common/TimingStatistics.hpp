@@ -0,0 +1,114 @@
+#ifndef MICROTECH_TIMINGSTATISTICS_HPP
+#define MICROTECH_TIMINGSTATISTICS_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Class that accumulates timing measurements of a piece of code running in an interrupt.
+ * Every measurement has a latency (how late the code started after the event that triggered it)
+ * and an execution time. Both are given in timer counts.
+ *
+ * It keeps the minimum, maximum and mean of both values and a histogram of the latency,
+ * so one can see how much the start of the code jitters. The update is done with additions
+ * and comparisons only, the division of the mean is only done when reading it.
+ *
+ * @tparam NUM_BINS Number of bins of the latency histogram. The last bin also counts all latencies bigger than it.
+ * @tparam BIN_WIDTH_SHIFT Width of each bin as a power of two: each bin is 2^BIN_WIDTH_SHIFT timer counts wide.
+ */
+template<uint8_t NUM_BINS = 8, uint8_t BIN_WIDTH_SHIFT = 1>
+class TimingStatistics {
+  static_assert(NUM_BINS > 0, "The histogram needs at least one bin");
+
+public:
+  /**
+   * Method to add a new measurement.
+   * @param latency Timer counts between the event and the start of the code
+   * @param executionTime Timer counts the code took to run
+   */
+  void record(uint16_t latency, uint16_t executionTime) noexcept {
+    if (numSamples == UINT16_MAX) {
+      // Halving the sums and the number of samples keeps the mean and avoids overflows.
+      latencySum >>= 1;
+      executionTimeSum >>= 1;
+      numSamples >>= 1;
+    }
+    numSamples++;
+    latencySum += latency;
+    executionTimeSum += executionTime;
+
+    if (latency < minLatency) {
+      minLatency = latency;
+    }
+    if (latency > maxLatency) {
+      maxLatency = latency;
+    }
+    if (executionTime < minExecutionTime) {
+      minExecutionTime = executionTime;
+    }
+    if (executionTime > maxExecutionTime) {
+      maxExecutionTime = executionTime;
+    }
+
+    uint16_t bin = latency >> BIN_WIDTH_SHIFT;
+    if (bin >= NUM_BINS) {
+      bin = NUM_BINS - 1;
+    }
+    if (latencyHistogram[bin] < UINT16_MAX) {
+      latencyHistogram[bin]++;
+    }
+  }
+
+  /**
+   * Method to clear all measurements.
+   */
+  void reset() noexcept {
+    *this = TimingStatistics();
+  }
+
+  uint16_t getNumSamples() const noexcept {
+    return numSamples;
+  }
+  uint16_t getMinLatency() const noexcept {
+    return (numSamples == 0) ? 0 : minLatency;
+  }
+  uint16_t getMaxLatency() const noexcept {
+    return maxLatency;
+  }
+  uint16_t getMeanLatency() const noexcept {
+    return (numSamples == 0) ? 0 : static_cast<uint16_t>(latencySum / numSamples);
+  }
+  uint16_t getMinExecutionTime() const noexcept {
+    return (numSamples == 0) ? 0 : minExecutionTime;
+  }
+  uint16_t getMaxExecutionTime() const noexcept {
+    return maxExecutionTime;
+  }
+  uint16_t getMeanExecutionTime() const noexcept {
+    return (numSamples == 0) ? 0 : static_cast<uint16_t>(executionTimeSum / numSamples);
+  }
+
+  /**
+   * @return The latency histogram. Bin n counts the latencies from n*2^BIN_WIDTH_SHIFT to
+   *         (n+1)*2^BIN_WIDTH_SHIFT - 1 timer counts. The counters saturate.
+   */
+  const std::array<uint16_t, NUM_BINS>& getLatencyHistogram() const noexcept {
+    return latencyHistogram;
+  }
+
+private:
+  uint16_t numSamples = 0;                    ///< Number of measurements in the sums
+  uint16_t minLatency = UINT16_MAX;           ///< Smallest latency measured
+  uint16_t maxLatency = 0;                    ///< Biggest latency measured
+  uint16_t minExecutionTime = UINT16_MAX;     ///< Smallest execution time measured
+  uint16_t maxExecutionTime = 0;              ///< Biggest execution time measured
+  uint32_t latencySum = 0;                    ///< Sum of the latencies, used for the mean
+  uint32_t executionTimeSum = 0;              ///< Sum of the execution times, used for the mean
+  std::array<uint16_t, NUM_BINS> latencyHistogram{};  ///< Histogram of the latency
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_TIMINGSTATISTICS_HPP
@@ -0,0 +1,232 @@
+#ifndef MICROTECH_TIMINGWHEEL_HPP
+#define MICROTECH_TIMINGWHEEL_HPP
+
+#include "helpers.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace Microtech {
+
+template<uint8_t SLOT_BITS, uint8_t NUM_LEVELS>
+class TimingWheel;
+
+/**
+ * Lightweight software timer handled by a TimingWheel. It replaces the hand-written counters
+ * that are decremented on every tick (debounce windows, note durations, settle times...).
+ * The timer is an intrusive list node, so starting it does not allocate anything.
+ */
+class SoftwareTimer {
+  template<uint8_t SLOT_BITS, uint8_t NUM_LEVELS>
+  friend class TimingWheel;
+
+public:
+  typedef void (*Callback)();  ///< Type definition of the expiry callback
+
+  /**
+   * Class constructor.
+   * @param callback Function called by the TimingWheel when the timer expires
+   * @param isPeriodic If true the timer is restarted with the same number of ticks every time it expires
+   */
+  explicit SoftwareTimer(Callback callback, bool isPeriodic = false) : callback(callback), isPeriodic(isPeriodic) {}
+  SoftwareTimer(const SoftwareTimer&) = delete;
+  SoftwareTimer& operator=(const SoftwareTimer&) = delete;
+
+  /**
+   * @return true if the timer is started and did not expire yet.
+   */
+  bool isRunning() const noexcept {
+    return previousNext != nullptr;
+  }
+
+private:
+  const Callback callback;
+  const bool isPeriodic;
+  uint16_t periodTicks = 0;                  ///< Ticks the timer was started with
+  uint16_t expiryTick = 0;                   ///< Tick of the wheel in which the timer expires
+  SoftwareTimer* next = nullptr;             ///< Next timer in the same slot
+  SoftwareTimer** previousNext = nullptr;    ///< Pointer that points to this timer. Allows O(1) removal
+};
+
+/**
+ * Hierarchical timing wheel. It handles any number of SoftwareTimers with one periodic tick,
+ * for example a Timer task. Starting, stopping and expiring a timer are O(1), so the cost of
+ * a tick does not depend on how many timers are pending. E.g.:
+ *  @code
+ *    TimingWheel<> timingWheel;
+ *    SoftwareTimer debounceTimer(&debounceElapsed);
+ *
+ *    void timingWheelTask() {  // Registered in a timer with a 10ms period
+ *      timingWheel.tick();
+ *    }
+ *
+ *    void buttonPressed() {
+ *      timingWheel.start(debounceTimer, 10);  // debounceElapsed() is called in 100ms
+ *    }
+ *  @endcode
+ *
+ * The wheel has NUM_LEVELS levels of 2^SLOT_BITS slots. A timer is put in the level whose slots
+ * cover its remaining time. Level 0 has one slot per tick and is expired slot by slot. When it wraps,
+ * the current slot of the next level is moved down to the lower levels (a cascade). So each timer
+ * is moved at most NUM_LEVELS - 1 times during its whole life.
+ *
+ * start() and stop() disable the interrupts while the lists are changed, so they can be called from
+ * the main loop, from other interrupts and from the timer callbacks. tick() also disables them for each
+ * change of the lists, but not while the callbacks run. So it can be called by a timer interrupt or by
+ * the main loop (e.g. through a DeferredQueue).
+ *
+ * @tparam SLOT_BITS Number of slots of each level as a power of two.
+ * @tparam NUM_LEVELS Number of levels. The longest timer has 2^(SLOT_BITS * NUM_LEVELS) ticks.
+ */
+template<uint8_t SLOT_BITS = 3, uint8_t NUM_LEVELS = 3>
+class TimingWheel {
+  static_assert(SLOT_BITS > 0 && NUM_LEVELS > 0, "The timing wheel needs at least one level with two slots");
+  static_assert(SLOT_BITS * NUM_LEVELS <= 15, "The range of the timing wheel must fit in 15 bits");
+
+public:
+  static constexpr uint16_t MAX_TICKS = 1U << (SLOT_BITS * NUM_LEVELS);  ///< Longest time a timer can be started with
+
+  /**
+   * Starts a timer, or restarts it if it is already running.
+   * @param timer Timer to start
+   * @param ticks Number of calls of tick() until the timer expires. 0 is handled as 1.
+   * @return true if the timer was started. False if the ticks are bigger than MAX_TICKS.
+   */
+  bool start(SoftwareTimer& timer, uint16_t ticks) noexcept {
+    if (ticks > MAX_TICKS) {
+      return false;
+    }
+    if (ticks == 0) {
+      ticks = 1;
+    }
+    CriticalSection criticalSection;
+    if (timer.isRunning()) {
+      unlink(timer);
+    }
+    timer.periodTicks = ticks;
+    timer.expiryTick = currentTick + ticks - 1;
+    insert(timer);
+    return true;
+  }
+
+  /**
+   * Stops a timer. Its callback is not called.
+   * @return true if the timer was running.
+   */
+  bool stop(SoftwareTimer& timer) noexcept {
+    CriticalSection criticalSection;
+    if (!timer.isRunning()) {
+      return false;
+    }
+    unlink(timer);
+    return true;
+  }
+
+  /**
+   * Method to be called periodically, e.g. by a timer task. Calls the callbacks of the timers that expire.
+   * Timers started by these callbacks are only due in the next ticks.
+   */
+  void tick() {
+    const uint16_t tickIndex = currentTick;
+    // When a level wraps, the current slot of the next level is distributed to the lower levels.
+    for (uint8_t level = 1; level < NUM_LEVELS && getSlotIndex(tickIndex, level - 1) == 0; level++) {
+      cascade(level, getSlotIndex(tickIndex, level));
+    }
+
+    // The expired timers are moved to a local list, so restarted timers don't land in it again.
+    SoftwareTimer* expiredTimers = nullptr;
+    {
+      CriticalSection criticalSection;
+      currentTick = tickIndex + 1;
+      SoftwareTimer*& slot = slots[0][getSlotIndex(tickIndex, 0)];
+      expiredTimers = slot;
+      slot = nullptr;
+      if (expiredTimers != nullptr) {
+        expiredTimers->previousNext = &expiredTimers;
+      }
+    }
+    SoftwareTimer* timer;
+    while ((timer = takeExpiredTimer(expiredTimers)) != nullptr) {
+      if (timer->callback != nullptr) {
+        timer->callback();  // It may start or stop any timer, including the ones still in expiredTimers
+      }
+    }
+  }
+
+private:
+  static constexpr uint16_t SLOT_MASK = (1U << SLOT_BITS) - 1;
+
+  static constexpr uint8_t getSlotIndex(uint16_t tick, uint8_t level) {
+    return static_cast<uint8_t>((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+  }
+
+  /**
+   * Puts the timer in the slot of the level that covers its remaining ticks.
+   */
+  void insert(SoftwareTimer& timer) {
+    const uint16_t remainingTicks = timer.expiryTick - currentTick;
+    uint8_t level = 0;
+    while (level < (NUM_LEVELS - 1) && remainingTicks >= (1U << (SLOT_BITS * (level + 1)))) {
+      level++;
+    }
+    link(slots[level][getSlotIndex(timer.expiryTick, level)], timer);
+  }
+
+  /**
+   * Moves all the timers of a slot to the lower levels. The interrupts are disabled for one timer at a time.
+   */
+  void cascade(uint8_t level, uint8_t slotIndex) {
+    SoftwareTimer*& slot = slots[level][slotIndex];
+    while (true) {
+      CriticalSection criticalSection;
+      if (slot == nullptr) {
+        return;
+      }
+      SoftwareTimer& timer = *slot;
+      unlink(timer);
+      insert(timer);
+    }
+  }
+
+  /**
+   * Removes the first timer of the expired timers and restarts it if it is periodic.
+   * @return The removed timer, whose callback has to be called. nullptr if there is none left.
+   */
+  SoftwareTimer* takeExpiredTimer(SoftwareTimer*& expiredTimers) {
+    CriticalSection criticalSection;
+    SoftwareTimer* timer = expiredTimers;
+    if (timer != nullptr) {
+      unlink(*timer);
+      if (timer->isPeriodic) {
+        timer->expiryTick += timer->periodTicks;  // Relative to the expiry, so the period does not drift
+        insert(*timer);
+      }
+    }
+    return timer;
+  }
+
+  static void link(SoftwareTimer*& head, SoftwareTimer& timer) {
+    timer.next = head;
+    if (head != nullptr) {
+      head->previousNext = &timer.next;
+    }
+    head = &timer;
+    timer.previousNext = &head;
+  }
+
+  static void unlink(SoftwareTimer& timer) {
+    *timer.previousNext = timer.next;
+    if (timer.next != nullptr) {
+      timer.next->previousNext = timer.previousNext;
+    }
+    timer.next = nullptr;
+    timer.previousNext = nullptr;
+  }
+
+  std::array<std::array<SoftwareTimer*, (1U << SLOT_BITS)>, NUM_LEVELS> slots{};  ///< Lists of timers of each slot
+  uint16_t currentTick = 0;  ///< Tick that is processed by the next call of tick()
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_TIMINGWHEEL_HPP
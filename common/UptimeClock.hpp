@@ -0,0 +1,76 @@
+#ifndef MICROTECH_UPTIMECLOCK_HPP
+#define MICROTECH_UPTIMECLOCK_HPP
+
+#include "Timer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+namespace Microtech {
+
+/**
+ * Monotonic clock based on a Timer_A running in continuous or tickless mode. The 16 bits counter
+ * is extended with the overflow interrupt, so the clock does not wrap in practice (48 bits, more than
+ * 70 years with SMCLK / 8). It fulfills the std::chrono Clock requirements, so the timestamps can be
+ * used with the std::chrono durations. E.g.:
+ *  @code
+ *    using Clock = UptimeClock<1, 8, 1>;  // Timer 1, clock divider 8, 1us source clock period
+ *
+ *    constexpr ContinuousTimerConfig<8, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+ *    Timer<1>::getTimer().init(TIMER_CONFIG);
+ *    Clock::start();
+ *    ...
+ *    const Clock::time_point start = Clock::now();
+ *    doSomething();
+ *    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+ *  @endcode
+ *
+ * For short measurements nowCounts() gives 32 bits timestamps, which are cheaper to store and subtract.
+ *
+ * @tparam TIMER_NUMBER The number of the timer. It can still be used for tasks.
+ * @tparam CLK_DIV Input divider of the timer clock, as in the timer config.
+ * @tparam SOURCE_CLK_PERIOD_US Period of the source clock in microseconds, as in the timer config.
+ * @tparam SOURCE_CLK_PERIOD_DEN Denominator of the source clock period, as in the timer config.
+ */
+template<uint8_t TIMER_NUMBER, int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN = 1>
+class UptimeClock {
+public:
+  using rep = uint64_t;
+  using period = std::ratio<CLK_DIV * SOURCE_CLK_PERIOD_US, 1000000 * SOURCE_CLK_PERIOD_DEN>;  ///< One timer count
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<UptimeClock>;
+  static constexpr bool is_steady = true;
+
+  UptimeClock() = delete;
+
+  /**
+   * Starts the clock. The timer must already be initialized in continuous or tickless mode.
+   * @return true if the clock was started.
+   */
+  static bool start() {
+    return Timer<TIMER_NUMBER>::getTimer().startUptime();
+  }
+
+  /**
+   * @return The current time since the clock was started.
+   */
+  static time_point now() noexcept {
+    return time_point(duration(Timer<TIMER_NUMBER>::getTimer().getUptimeCounts()));
+  }
+
+  /**
+   * @return The lower 32 bits of the current time in timer counts. The difference of two values is
+   *         correct as long as they are less than 2^32 counts apart (more than 9 hours with SMCLK / 8).
+   */
+  static uint32_t nowCounts() noexcept {
+    return static_cast<uint32_t>(Timer<TIMER_NUMBER>::getTimer().getUptimeCounts());
+  }
+};
+
+template<uint8_t TIMER_NUMBER, int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, int64_t SOURCE_CLK_PERIOD_DEN>
+constexpr bool UptimeClock<TIMER_NUMBER, CLK_DIV, SOURCE_CLK_PERIOD_US, SOURCE_CLK_PERIOD_DEN>::is_steady;
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_UPTIMECLOCK_HPP
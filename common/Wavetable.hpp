@@ -0,0 +1,159 @@
+#ifndef MICROTECH_WAVETABLE_HPP
+#define MICROTECH_WAVETABLE_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Microtech {
+
+/**
+ * Shapes of the wavetables. All of them go from 0 to the maximum value of the table.
+ */
+enum class WaveShape {
+  SINE,       ///< Sine shifted up by half of the range. Starts at the middle, rising
+  TRAPEZOID,  ///< Starts at the middle, rises until 30 deg, high until 150 deg, falls until 210 deg, low until 330 deg
+  RECTANGLE,  ///< High in the first half of the period, low in the second one
+};
+
+/**
+ * Values of a wavetable. The last entry repeats the first one, so the interpolation needs no wrap around.
+ */
+template<typename ValueType, uint16_t SIZE>
+struct WavetableValues {
+  ValueType values[SIZE + 1];
+};
+
+/**
+ * Class that calculates the wavetables in compile time. Only needed by the Wavetable.
+ */
+class WavetableGenerator {
+public:
+  WavetableGenerator() = delete;
+
+  /**
+   * @tparam ValueType Type of the values
+   * @tparam SIZE Number of points of a period
+   * @param shape Shape of the table
+   * @param maxValue Value at the top of the shape
+   * @return The values of one period, rounded
+   */
+  template<typename ValueType, uint16_t SIZE>
+  static constexpr WavetableValues<ValueType, SIZE> generate(WaveShape shape, uint16_t maxValue) {
+    WavetableValues<ValueType, SIZE> table{};
+    for (uint32_t i = 0; i <= SIZE; i++) {
+      const double level = getLevel(shape, static_cast<double>(i % SIZE) / SIZE);
+      table.values[i] = static_cast<ValueType>(level * maxValue + 0.5);
+    }
+    return table;
+  }
+
+private:
+  static constexpr double PI = 3.14159265358979323846;
+
+  /**
+   * @param shape Shape of the signal
+   * @param phase Phase as a fraction of the period, from 0 to 1 (exclusive)
+   * @return The level of the shape from 0 to 1
+   */
+  static constexpr double getLevel(WaveShape shape, double phase) {
+    switch (shape) {
+      case WaveShape::SINE: return (1.0 + sine(2.0 * PI * phase)) / 2.0;
+      case WaveShape::TRAPEZOID:
+        // Slope of 1 over 60 degrees, which is 1/6 of the period
+        if (phase < 1.0 / 12) {
+          return 0.5 + 6.0 * phase;
+        } else if (phase < 5.0 / 12) {
+          return 1.0;
+        } else if (phase < 7.0 / 12) {
+          return 1.0 - 6.0 * (phase - 5.0 / 12);
+        } else if (phase < 11.0 / 12) {
+          return 0.0;
+        }
+        return 6.0 * (phase - 11.0 / 12);
+      case WaveShape::RECTANGLE: return (phase < 0.5) ? 1.0 : 0.0;
+    }
+    return 0.0;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  /**
+   * Sine with its Taylor series, since std::sin cannot be used in compile time.
+   * @param x Angle in radians, from 0 to 2 pi
+   */
+  static constexpr double sine(double x) {
+    if (x > PI) {
+      x -= 2.0 * PI;  // The series converges faster from -pi to pi
+    }
+    double term = x;
+    double sum = x;
+    for (int n = 1; n <= 12; n++) {
+      term *= -x * x / ((2 * n) * (2 * n + 1));
+      sum += term;
+    }
+    return sum;
+  }
+};
+
+/**
+ * Lookup table of one period of a wave shape, calculated in compile time and stored in flash. It is indexed by a
+ * 32 bits phase accumulator (see SignalProperties), so each sample costs one table read, plus a multiplication
+ * with linear interpolation. The size and the top value set the trade-off between accuracy and flash. E.g.:
+ *  @code
+ *    using SineTable = Wavetable<WaveShape::SINE, 8, 4096>;  // 256 points from 0 to 4096, 514 bytes of flash
+ *    const uint16_t value = SineTable::interpolate(phase);
+ *  @endcode
+ *
+ * @tparam SHAPE Shape of the table
+ * @tparam SIZE_BITS Number of points of a period as a power of two, from 1 to 12. The index is the upper
+ *                   SIZE_BITS bits of the phase.
+ * @tparam MAX_VALUE Value at the top of the shape. Up to 255 the values take one byte each. A power of two
+ *                   makes the scaling of the values exact (see WavetableSignal).
+ */
+template<WaveShape SHAPE, uint8_t SIZE_BITS, uint16_t MAX_VALUE>
+class Wavetable {
+  static_assert(SIZE_BITS >= 1 && SIZE_BITS <= 12, "The wavetable can have from 2 to 4096 points");
+  static_assert(MAX_VALUE >= 1, "The top of the wavetable must be at least 1");
+
+public:
+  using ValueType = typename std::conditional<(MAX_VALUE <= UINT8_MAX), uint8_t, uint16_t>::type;
+
+  static constexpr uint16_t SIZE = 1U << SIZE_BITS;  ///< Points of a period
+
+  Wavetable() = delete;
+
+  /**
+   * @param phase Phase where 2^32 is a full period
+   * @return The value of the point at or before the phase.
+   */
+  static uint16_t lookup(uint32_t phase) noexcept {
+    return TABLE.values[phase >> INDEX_SHIFT];
+  }
+
+  /**
+   * Interpolates linearly between the two points around the phase, with 8 bits of resolution.
+   * @param phase Phase where 2^32 is a full period
+   * @return The interpolated value.
+   */
+  static uint16_t interpolate(uint32_t phase) noexcept {
+    const uint16_t index = static_cast<uint16_t>(phase >> INDEX_SHIFT);
+    const uint8_t fraction = static_cast<uint8_t>(phase >> (INDEX_SHIFT - 8));
+    const int32_t first = TABLE.values[index];
+    const int32_t difference = static_cast<int32_t>(TABLE.values[index + 1]) - first;
+    // The shift of a negative value is arithmetic on the MSP430 compilers.
+    return static_cast<uint16_t>(first + ((difference * fraction) >> 8));
+  }
+
+private:
+  static constexpr uint8_t INDEX_SHIFT = 32 - SIZE_BITS;
+
+  static constexpr WavetableValues<ValueType, SIZE> TABLE =
+    WavetableGenerator::generate<ValueType, SIZE>(SHAPE, MAX_VALUE);
+};
+
+template<WaveShape SHAPE, uint8_t SIZE_BITS, uint16_t MAX_VALUE>
+constexpr WavetableValues<typename Wavetable<SHAPE, SIZE_BITS, MAX_VALUE>::ValueType,
+                          Wavetable<SHAPE, SIZE_BITS, MAX_VALUE>::SIZE>
+  Wavetable<SHAPE, SIZE_BITS, MAX_VALUE>::TABLE;
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_WAVETABLE_HPP
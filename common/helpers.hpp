@@ -13,6 +13,7 @@
 #ifndef MICROTECH_HELPERS_HPP
 #define MICROTECH_HELPERS_HPP
 
+#include <msp430g2553.h>
 #include <cstdint>
 
 /**
@@ -108,4 +109,31 @@ constexpr TYPE getRegisterBits(volatile TYPE& registerRef, TYPE bitSelection, TY
   return (registerRef & bitSelection) >> shiftsRight;
 }
 
+/**
+ * Class to protect a critical section from interrupts.
+ * The interrupts are disabled when the object is created and the previous interrupt state
+ * is restored when it goes out of scope, so it can also be used inside of interrupts
+ * or nested critical sections. E.g.:
+ *  @code
+ *    {
+ *      CriticalSection criticalSection;
+ *      sharedValue++;  // Cannot be interrupted
+ *    }
+ *  @endcode
+ */
+class CriticalSection {
+public:
+  CriticalSection() : interruptState(_get_interrupt_state()) {
+    _disable_interrupt();
+  }
+  ~CriticalSection() {
+    _set_interrupt_state(interruptState);
+  }
+  CriticalSection(const CriticalSection&) = delete;
+  CriticalSection& operator=(const CriticalSection&) = delete;
+
+private:
+  const unsigned short interruptState;  ///< Status register before the interrupts were disabled
+};
+
 #endif  // MICROTECH_HELPERS_HPP
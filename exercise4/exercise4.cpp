@@ -13,8 +13,10 @@
  *              The ADC value gets automatically updated by the usage of the DTC. For more details, please look in
  *              common/Adc.hpp.
  *
- *              Timer0 was setup with an interruption of 10ms and at every interrupt the ADC values of the potentiometer
- *              and from the LDR were evaluated in two separate functions.
+ *              The timer 0 triggers one ADC conversion every 1ms, so the sequence of the channels 7 to 0 is converted
+ *              every 8ms and the filters of the ADC interrupt run at 125Hz. Timer1 was setup with an interruption of
+ *              10ms and at every interrupt the LDR value is evaluated. The LEDs of the potentiometer are only
+ *              written when its value crosses a threshold.
  *
  *              For the bonus point the detection of YELLOW was added using a Post-it
  *
@@ -56,6 +58,7 @@
 #include "Timer.hpp"
 
 #include "Adc.hpp"
+#include "DeferredQueue.hpp"
 #include "ShiftRegister.hpp"
 
 #include <chrono>
@@ -83,27 +86,41 @@ const char* colorStr = "";  // the color that will be printed.
 uint8_t idOfColorToPrint = 20;
 uint16_t printLdrVal = 0;
 
-static AdcHandle potentiometer = Adc::getInstance().getAdcHandle<7>(); // Statically creates the handle that reads from the ADC, input 7
-static AdcHandle ldr = Adc::getInstance().getAdcHandle<4>(); // Statically creates the handle that reads from the ADC, input 4
+// Period of the timer 0 trigger of the ADC. Each trigger converts one channel of the sequence 7 to 0, so each
+// channel is sampled every 8ms.
+constexpr uint16_t ADC_TRIGGER_PERIOD_MS = 1;
+
+// Handle of the LDR, input 4. It is filtered by a moving average in the ADC interrupt. 32 samples of 8ms
+// average the last 256ms, which smooths the noise but still follows a chip that is put on the LDR.
+static FilteredAdcHandle<Sma<32>> ldr;
+
+// Calls of the ADC interrupt that are executed by the main loop.
+DeferredQueue<4> deferredQueue;
+
+volatile uint8_t potentiometerBand = 0;  // Band of the potentiometer value, from 0 to 4
+
 /**
- * Function that evaluates the potentiometer ADC values and set the turn on the appropriate LEDs.
+ * Function called by the main loop after the potentiometer value moved to another band. It turns on the
+ * appropriate LEDs.
  */
-void evaluatePotentiometer() {
-  const uint16_t potValue = potentiometer.getRawValue();
-
-  if (potValue < 204) {
-    shiftRegisterLEDs.writeValue(0x00);
-  } else if (potValue < 408) {
-    shiftRegisterLEDs.writeValue(0x01);
-  } else if (potValue < 612) {
-    shiftRegisterLEDs.writeValue(0x03);
-  } else if (potValue < 816) {
-    shiftRegisterLEDs.writeValue(0x07);
-  } else {
-    shiftRegisterLEDs.writeValue(0x0F);
-  }
+void writePotentiometerLeds() {
+  static constexpr uint8_t LED_PATTERNS[] = {0x00, 0x01, 0x03, 0x07, 0x0F};
+  shiftRegisterLEDs.writeValue(LED_PATTERNS[potentiometerBand]);
 }
 
+/**
+ * Function called by the ADC interrupt when the potentiometer value moves to another band. Writing the shift
+ * register takes too long for the interrupt, so the LEDs are written by the main loop.
+ * @param band Band of the potentiometer value, from 0 to 4
+ */
+void potentiometerBandChanged(uint8_t band) {
+  potentiometerBand = band;
+  deferredQueue.post(&writePotentiometerLeds);
+}
+
+// Events of the potentiometer, input 7. The LEDs are only written when the value crosses a threshold.
+static AdcThresholdEvent<4> potentiometerEvent({{204, 408, 612, 816}}, 8, &potentiometerBandChanged);
+
 /**
  * Function that evaluates the LDR ADC values and specifies which string should be printed via serial
  */
@@ -126,8 +143,8 @@ void evaluateLDR() {
   // so we can filter for the settling time of the LDR.
   static uint8_t lastColorId = 99;  // Just initialize to some random number different than 0
 
-  // Get the filtered value of the LDR. A Moving average over the last 30 samples.
-  const uint16_t ldrValue = ldr.getFilteredValue();
+  // Get the filtered value of the LDR. A Moving average over the last 32 samples.
+  const uint16_t ldrValue = ldr.getValue();
   uint8_t colorId = 0;  // Variable used to loop through the color table
 
   // Color table loop.
@@ -165,17 +182,25 @@ void evaluateLDR() {
 }
 
 void evaluateAdcTask() {
-  evaluatePotentiometer();
   evaluateLDR();
 }
 
-using Timer0 = Timer<0, 8>;
-
 int main() {
   initMSP();
 
-  Timer0::getTimer().init();
+  // Timer with CLK_DIV = 8 and since the period of SMCLK is 1us we also let the timer know that.
+  constexpr TimerConfigBase<8, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+  Timer<1>::getTimer().init(TIMER_CONFIG);
+
+  // The timer 0 triggers the conversions. Without a trigger the ADC converts continuously and the ADC interrupt
+  // of the listeners would come every few tens of microseconds. So the listeners are registered afterwards.
+  // A timer count of 1us makes the 1ms trigger a whole number of counts.
+  constexpr TimerConfigBase<1, 1> ADC_TIMER_CONFIG(TimerClockSource::Option::SMCLK);
   Adc::getInstance().init();
+  Adc::getInstance().setTimerTrigger<AdcTrigger::TIMER0_OUT0, ADC_TRIGGER_PERIOD_MS, std::chrono::milliseconds>(
+    ADC_TIMER_CONFIG);
+  Adc::getInstance().registerListener<4>(ldr);
+  Adc::getInstance().registerListener<7>(potentiometerEvent);
   shiftRegisterLEDs.init();
 
   constexpr OutputHandle redLed = GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(0)>();
@@ -195,8 +220,8 @@ int main() {
   // Creates a 10ms periodic task for evaluating the adc values.
   TaskHandler<10, std::chrono::milliseconds> adcTask(&evaluateAdcTask, true);
 
-  // registers adc task to timer 0
-  Timer0::getTimer().registerTask(adcTask);
+  // registers adc task to timer 1
+  Timer<1>::getTimer().registerTask(TIMER_CONFIG, adcTask);
 
   Adc::getInstance().startConversion();
   uint8_t lastPrintedColorId = 99;
@@ -204,9 +229,7 @@ int main() {
   // globally enables the interrupts.
   __enable_interrupt();
   while (true) {
-    ADC10CTL0 &= ~ENC;
-    while (ADC10CTL1 & ADC10BUSY){}     // Waits until ADC sampling is done
-    ADC10CTL0 |= ENC + ADC10SC;  // Triggers new sampling from the ADC
+    deferredQueue.runAll();
     if (lastPrintedColorId != idOfColorToPrint) {
       lastPrintedColorId = idOfColorToPrint;
       serialPrintln(colorStr);
@@ -49,12 +49,20 @@
 #include "ShiftRegister.hpp"
 #include "Timer.hpp"
 #include "Pwm.hpp"
+#include "ClockSystem.hpp"
 
 //#define WATCHDOG_TIME_5_SECONDS
 #define CONTROL_WITH_PWM
 
 using namespace Microtech;
 
+// DCO at 1MHz, ACLK from the VLO divided by 2 or 8 for the watchdog.
+#ifdef WATCHDOG_TIME_5_SECONDS
+using Clocks = ClockSystem<DcoFrequency::MHZ_1, 1, 2>;
+#else
+using Clocks = ClockSystem<DcoFrequency::MHZ_1, 1, 8>;
+#endif
+
 // Button that causes deadlock
 Button PB5(GPIOs::getInputHandle<IOPort::PORT_1, static_cast<uint8_t>(3)>(), true);
 
@@ -62,7 +70,7 @@ Button PB5(GPIOs::getInputHandle<IOPort::PORT_1, static_cast<uint8_t>(3)>(), tru
 #ifndef CONTROL_WITH_PWM
 constexpr OutputHandle heatingResistorOnOffPin = GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(4)>();
 #else
-Pwm heatingResistorPwm(
+BasicPwm<Clocks::SmclkTimerConfig<8>> heatingResistorPwm(
   GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(5)>());  // Create handle of PWM for pin 6 from port 5
 #endif
 // NTC ADC value range: 320 - 570
@@ -92,35 +100,29 @@ void displaytemperatureTaskFunc() {
     constexpr uint16_t VALUE_LED3 = VALUE_LED2 + NTC_INTERVAL_VALUE;
     constexpr uint16_t VALUE_LED4 = VALUE_LED3 + NTC_INTERVAL_VALUE;
 
-    static uint16_t numInterrupts = 0;
-    if(numInterrupts < 2000) {
-        numInterrupts++;
+    const uint16_t ntcValue = NTC_input.getRawValue();
+    currentNtcValue = ntcValue;
+
+    if(ntcValue < VALUE_LED1) {
+        ledD1ToD4.writeValue(0x1);
+        redLed.setState(IOState::LOW);
+        currentTemperatureRange = 1;
+    } else if(ntcValue < VALUE_LED2) {
+        ledD1ToD4.writeValue(0x3);
+        redLed.setState(IOState::LOW);
+        currentTemperatureRange = 2;
+    } else if(ntcValue < VALUE_LED3) {
+        ledD1ToD4.writeValue(0x7);
+        redLed.setState(IOState::LOW);
+        currentTemperatureRange = 3;
+    } else if(ntcValue < VALUE_LED4) {
+        ledD1ToD4.writeValue(0xF);
+        redLed.setState(IOState::LOW);
+        currentTemperatureRange = 4;
     } else {
-        numInterrupts = 0;
-        const uint16_t ntcValue = NTC_input.getRawValue();
-        currentNtcValue = ntcValue;
-
-        if(ntcValue < VALUE_LED1) {
-            ledD1ToD4.writeValue(0x1);
-            redLed.setState(IOState::LOW);
-            currentTemperatureRange = 1;
-        } else if(ntcValue < VALUE_LED2) {
-            ledD1ToD4.writeValue(0x3);
-            redLed.setState(IOState::LOW);
-            currentTemperatureRange = 2;
-        } else if(ntcValue < VALUE_LED3) {
-            ledD1ToD4.writeValue(0x7);
-            redLed.setState(IOState::LOW);
-            currentTemperatureRange = 3;
-        } else if(ntcValue < VALUE_LED4) {
-            ledD1ToD4.writeValue(0xF);
-            redLed.setState(IOState::LOW);
-            currentTemperatureRange = 4;
-        } else {
-            ledD1ToD4.writeValue(0xF);
-            redLed.setState(IOState::HIGH);
-            currentTemperatureRange = 5;
-        }
+        ledD1ToD4.writeValue(0xF);
+        redLed.setState(IOState::HIGH);
+        currentTemperatureRange = 5;
     }
 }
 void pb5Callback(ButtonState /*buttonState*/) {
@@ -131,14 +133,8 @@ int main() {
  Timer<0>::getTimer().stop();   // Stops the timer first to since after registers are in undefined state after watchdog
  initMSP();
 
- // VLOCLK is 12 kHz according to datasheet, page 276.
- // Route VLOCLK to ACKL.
- BCSCTL3 |= LFXT1S_2;
-#ifdef WATCHDOG_TIME_5_SECONDS
- BCSCTL1 |= DIVA_1;  // Set ACKL divider to 2.
-#else
- BCSCTL1 |= DIVA_3;  // Set ACKL divider to 8.
-#endif
+ // VLOCLK is 12 kHz according to datasheet, page 276. It is routed to ACKL by the ClockSystem.
+ Clocks::init();
 
  constexpr OutputHandle greenLed = GPIOs::getOutputHandle<IOPort::PORT_1, static_cast<uint8_t>(0)>();
  greenLed.init();
@@ -165,11 +161,12 @@ int main() {
  Adc::getInstance().init();
  Adc::getInstance().startConversion();
 
- // Timer with CLK_DIV = 8 and since the period of SMCLK is 1us we also let the timer know that.
- constexpr TimerConfigBase<1, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+ // Timer with CLK_DIV = 8. The ClockSystem lets the timer know the period of SMCLK.
+ // The timer has a base tick of 50ms.
+ constexpr Clocks::SmclkTimerConfig<8, 50, std::chrono::milliseconds> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
  Timer<0>::getTimer().init(TIMER_CONFIG);
- // Creates a 1ms periodic task
- TaskHandler<1, std::chrono::milliseconds> displayTemperatureTask(&displaytemperatureTaskFunc, true);
+ // Creates a 2s periodic task (0.5Hz refresh rate). The timer calls it every 40 ticks.
+ TaskHandler<2, std::chrono::seconds> displayTemperatureTask(&displaytemperatureTaskFunc, true);
  Timer<0>::getTimer().registerTask(TIMER_CONFIG, displayTemperatureTask);
 
  // Enable watchdog
@@ -13,6 +13,8 @@
  *                  The amplitude of the signals can also be adjusted with an amplitude step of 0.05.
  *
  *                  The oscilloscope prints new values every 20ms.
+ *                  The timer interrupt only samples and updates the PWM. The serial print and the
+ *                  shift register read are deferred to the main loop, so the interrupt stays short.
  *
  * Pin connections:
  *       CON3:P1.0 <-> DAC_OUT
@@ -32,6 +34,7 @@
 
 #include "Adc.hpp"
 #include "Button.hpp"
+#include "DeferredQueue.hpp"
 #include "GPIOs.hpp"
 #include "Pwm.hpp"
 #include "ShiftRegister.hpp"
@@ -52,6 +55,11 @@ SignalGenerator signalGenerator(50);
 // Create handle of PWM for pin 6 from port 3
 Pwm DAC_IN(GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(6)>());
 
+// Calls handed over from the timer interrupt to the main loop
+DeferredQueue<4> deferredQueue;
+// Oscilloscope value sampled in the timer interrupt, printed by the main loop
+volatile uint16_t oscilloscopeSample = 0;
+
 constexpr ShiftRegisterPB pb1to4(GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(4)>(),
                                  GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(5)>(),
                                  GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(2)>(),
@@ -70,19 +78,22 @@ void decreaseCounter(uint8_t &counter) {
 }
 
 /**
- * @brief Interrupt service routine called by the timer
- * It will read the values of the oscilloscope and send it to the serial port
- * It also handles the debouncing of the buttons and updates the signal generator's
- * amplitude and frequency based on user input.
+ * @brief Sends the latest oscilloscope sample to the serial port.
+ * Executed by the main loop.
  */
-void timerInterrupt() {
-  _iq15 nextDatapoint = signalGenerator.getNextDatapoint();
-  // Print values of Oscilloscope
-  serialPrintInt(adcCH1.getRawValue());
+void printOscilloscopeSample() {
+  serialPrintInt(oscilloscopeSample);
   //serialPrint(" ");
   //serialPrintInt(_IQ15int(nextDatapoint)); // For debugging purposes
   serialPrintln("");
+}
 
+/**
+ * @brief Reads the push buttons of the shift register (PB1-4), performs their debounce and
+ * updates the signal generator's shape and frequency based on user input.
+ * Executed by the main loop once per timer tick, so the debounce counters still count timer ticks.
+ */
+void evaluatePushButtons() {
   // Get the current PB values of the shift register (PB1-4)
   uint8_t PBvalues = pb1to4.getPBValues();
 
@@ -112,6 +123,19 @@ void timerInterrupt() {
   decreaseCounter(PB2debounceCnt);
   decreaseCounter(PB3debounceCnt);
   decreaseCounter(PB4debounceCnt);
+}
+
+/**
+ * @brief Interrupt service routine called by the timer
+ * It samples the oscilloscope, handles the debouncing of the buttons PB5 and PB6 and updates the PWM output.
+ * The serial print and the shift register read are slow, so they are deferred to the main loop.
+ */
+void timerInterrupt() {
+  _iq15 nextDatapoint = signalGenerator.getNextDatapoint();
+  oscilloscopeSample = adcCH1.getRawValue();
+  deferredQueue.post(&printOscilloscopeSample);
+  deferredQueue.post(&evaluatePushButtons);
+
   btnDecreaseAmplitude.evaluateDebounce();
   btnIncreaseAmplitude.evaluateDebounce();
 
@@ -162,7 +186,7 @@ int main() {
   Timer<1>::getTimer().registerTask(TIMER_CONFIG, timerTask);
 
   while (true) {
-    _no_operation();
+    deferredQueue.runAll();
   }
 
   return 0;
@@ -2,6 +2,7 @@
 #define MICROTECH_IQMATHLIB_H
 
 #include <cmath>
+#include <cstdint>
 
 typedef double _iq15;
 #define _IQ15(X) _iq15(X)
@@ -14,10 +15,22 @@ constexpr _iq15 _IQ15div(const _iq15 val1, const _iq15 val2) {
   return val1/val2;
 }
 
+constexpr int _IQ15int(const _iq15 val) {
+  return static_cast<int>(val);
+}
+
 constexpr _iq15 _IQ15sin(const _iq15 phase) {
   return std::sin(phase);
 }
 
+constexpr _iq15 _IQ15mpyI32(const _iq15 val1, const int32_t val2) {
+  return val1 * val2;
+}
+
+constexpr _iq15 _IQ15sinPU(const _iq15 phase) {
+  return std::sin(2 * M_PI * phase);
+}
+
 
 
 #endif  // MICROTECH_IQMATHLIB_H
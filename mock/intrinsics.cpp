@@ -4,6 +4,22 @@ void __enable_interrupt(void) {
 
 }
 
+void __disable_interrupt(void) {
+
+}
+
+unsigned short __get_SR_register(void) {
+  return 0;
+}
+
+void __set_interrupt_state(unsigned short /*state*/) {
+
+}
+
 void __no_operation(void) {
 
 }
+
+unsigned int __even_in_range(unsigned int val, unsigned int /*range*/) {
+  return val;
+}
@@ -4,6 +4,18 @@
 #define DECLARE_8BIT_REGISTER(regName, initValue)  volatile uint8_t regName = initValue;
 #define DECLARE_16BIT_REGISTER(regName, initValue) volatile uint16_t regName = initValue;
 
+DECLARE_8BIT_REGISTER(DCOCTL, 0)
+DECLARE_8BIT_REGISTER(BCSCTL1, 0)
+DECLARE_8BIT_REGISTER(BCSCTL2, 0)
+DECLARE_8BIT_REGISTER(BCSCTL3, 0)
+DECLARE_8BIT_REGISTER(CALDCO_1MHZ, 0)
+DECLARE_8BIT_REGISTER(CALBC1_1MHZ, 0)
+DECLARE_8BIT_REGISTER(CALDCO_8MHZ, 0)
+DECLARE_8BIT_REGISTER(CALBC1_8MHZ, 0)
+DECLARE_8BIT_REGISTER(CALDCO_12MHZ, 0)
+DECLARE_8BIT_REGISTER(CALBC1_12MHZ, 0)
+DECLARE_8BIT_REGISTER(CALDCO_16MHZ, 0)
+DECLARE_8BIT_REGISTER(CALBC1_16MHZ, 0)
 DECLARE_8BIT_REGISTER(P1DIR, 0)
 DECLARE_8BIT_REGISTER(P1IN, 0)
 DECLARE_8BIT_REGISTER(P1OUT, 0)
@@ -22,9 +34,30 @@ DECLARE_8BIT_REGISTER(P2SEL2, 0)
 DECLARE_8BIT_REGISTER(P2IE, 0)
 DECLARE_8BIT_REGISTER(P2IES, 0)
 DECLARE_8BIT_REGISTER(P2IFG, 0)
+DECLARE_8BIT_REGISTER(P3DIR, 0)
+DECLARE_8BIT_REGISTER(P3IN, 0)
+DECLARE_8BIT_REGISTER(P3OUT, 0)
+DECLARE_8BIT_REGISTER(P3REN, 0)
+DECLARE_8BIT_REGISTER(P3SEL, 0)
+DECLARE_8BIT_REGISTER(P3SEL2, 0)
 DECLARE_16BIT_REGISTER(TA0CCR0, 0)
+DECLARE_16BIT_REGISTER(TA0CCR1, 0)
+DECLARE_16BIT_REGISTER(TA0CCR2, 0)
 DECLARE_16BIT_REGISTER(TA0CCTL0, 0)
+DECLARE_16BIT_REGISTER(TA0CCTL1, 0)
+DECLARE_16BIT_REGISTER(TA0CCTL2, 0)
 DECLARE_16BIT_REGISTER(TA0CTL, 0)
+DECLARE_16BIT_REGISTER(TA0R, 0)
+DECLARE_16BIT_REGISTER(TA0IV, 0)
+DECLARE_16BIT_REGISTER(TA1CCR0, 0)
+DECLARE_16BIT_REGISTER(TA1CCR1, 0)
+DECLARE_16BIT_REGISTER(TA1CCR2, 0)
+DECLARE_16BIT_REGISTER(TA1CCTL0, 0)
+DECLARE_16BIT_REGISTER(TA1CCTL1, 0)
+DECLARE_16BIT_REGISTER(TA1CCTL2, 0)
+DECLARE_16BIT_REGISTER(TA1CTL, 0)
+DECLARE_16BIT_REGISTER(TA1R, 0)
+DECLARE_16BIT_REGISTER(TA1IV, 0)
 
 DECLARE_8BIT_REGISTER(ADC10AE0,0)
 DECLARE_8BIT_REGISTER(ADC10DTC0,0)
@@ -13,4 +13,8 @@ void serialPrintln(const char* tx) {
 
 }
 
+void serialPrintInt(int /*i*/) {
+
+}
+
 #endif  // MICROTECH_TEMPLATEEMP_H